@@ -0,0 +1,21 @@
+// Project identifier: 43DE0E0C4C76BFAA6D8C2F5AEAE0518A9C42CF4E
+
+#ifndef ALLOCATOR_H
+#define ALLOCATOR_H
+
+#include <memory>
+#include <memory_resource>
+#include <vector>
+
+// The array-based PQs (UnorderedPQ, UnorderedFastPQ, SortedPQ, BinaryPQ)
+// take an ALLOCATOR template parameter for their elements, and allocate
+// their per-element bookkeeping (erase handles, insertion numbers) through
+// it as well, rebound to the bookkeeping's type. Each has a Pmr alias that
+// uses std::pmr::polymorphic_allocator, so the memory_resource can be
+// chosen at run time, e.g.
+//     std::pmr::monotonic_buffer_resource arena { buffer, sizeof(buffer) };
+//     PmrBinaryPQ<int> pq { std::less<int> {}, &arena };
+template<typename T, typename ALLOCATOR>
+using AllocVector = std::vector<T, typename std::allocator_traits<ALLOCATOR>::template rebind_alloc<T>>;
+
+#endif  // ALLOCATOR_H
@@ -0,0 +1,247 @@
+// Project identifier: 43DE0E0C4C76BFAA6D8C2F5AEAE0518A9C42CF4E
+
+#ifndef ASYNCPQ_H
+#define ASYNCPQ_H
+
+#if __cplusplus < 202002L
+#error "AsyncPQ.hpp needs C++20 coroutines; build with -std=c++20"
+#endif
+
+#include <coroutine>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "BinaryPQ.hpp"
+
+// Runs posted work and coroutines on the thread that calls run(), one
+// after another, so that handing an element from a producer to a waiting
+// consumer costs a function call rather than a context switch.
+class AsyncExecutor {
+public:
+    // Description: Queue task to be run by run().
+    // Runtime: O(1)
+    void post(std::function<void()> task) { tasks.push_back(std::move(task)); }
+
+    // Description: Queue a suspended coroutine to be resumed by run().
+    // Runtime: O(1)
+    void post(std::coroutine_handle<> handle) {
+        post([handle] { handle.resume(); });
+    }  // post()
+
+    // Description: Run queued tasks, including any they post, until there
+    //              are none left. Returns the number of tasks run.
+    // Runtime: O(number of tasks)
+    std::size_t run() {
+        std::size_t ran = 0;
+        while (!tasks.empty()) {
+            std::function<void()> task = std::move(tasks.front());
+            tasks.pop_front();
+            task();
+            ++ran;
+        }
+        return ran;
+    }  // run()
+
+    // Description: Return true if no task is queued.
+    // Runtime: O(1)
+    [[nodiscard]] bool idle() const { return tasks.empty(); }
+
+private:
+    std::deque<std::function<void()>> tasks;
+};  // AsyncExecutor
+
+
+// The return type of a detached coroutine: it starts running as soon as it
+// is called and frees itself when it finishes. An exception that escapes
+// it terminates the program.
+struct AsyncTask {
+    struct promise_type {
+        AsyncTask get_return_object() { return {}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+    };
+};  // AsyncTask
+
+
+// A wrapper over any Eecs281PQ that coroutines can wait on:
+//     int job = co_await pq.pop_async();
+// suspends until the PQ has an element, then removes the most extreme one
+// and returns it. Waiters can be given a priority of their own; when
+// elements arrive, the highest priority waiter gets the most extreme
+// element, the next waiter the next one, and so on, with ties between
+// waiters going to the one that has waited longest.
+//
+// Without an executor, push() resumes waiters right away, inside the call.
+// With one, push() only schedules a wakeup; every push before the executor
+// gets to it is handed out in the same batch, in priority order.
+//
+// Not thread-safe: the PQ, its waiters and the executor belong to one
+// thread. The AsyncPQ must outlive its waiters and any wakeup it has
+// posted to the executor.
+template<typename PQ>
+class AsyncPQ {
+public:
+    using value_type = std::remove_cv_t<std::remove_reference_t<decltype(std::declval<const PQ &>().top())>>;
+    using Priority = int;
+
+    // Returned by pop_async(), for co_await.
+    class PopAwaiter {
+    public:
+        PopAwaiter(AsyncPQ &pq, Priority priority)
+            : owner { pq }
+            , priority { priority } {}
+
+        // Take an element without suspending if one is available and no
+        // other coroutine is waiting.
+        bool await_ready() {
+            if (owner.waiters.empty() && !owner.queue.empty()) {
+                item.emplace(owner.queue.top());
+                owner.queue.pop();
+                return true;
+            }
+            return false;
+        }
+
+        void await_suspend(std::coroutine_handle<> waiting) {
+            handle = waiting;
+            owner.waiters.push({ priority, this });
+        }
+
+        value_type await_resume() { return std::move(*item); }
+
+        friend AsyncPQ;
+
+    private:
+        AsyncPQ &owner;
+        Priority priority;
+        std::coroutine_handle<> handle;
+        std::optional<value_type> item;
+    };  // PopAwaiter
+
+
+    // Description: Wrap pq, resuming waiters through executor if one is
+    //              given, or inside push() otherwise.
+    // Runtime: O(1)
+    explicit AsyncPQ(AsyncExecutor *executor = nullptr, PQ pq = PQ())
+        : queue { std::move(pq) }
+        , executor { executor } {
+        waiters.setStable(true);
+    }  // AsyncPQ()
+
+
+    // Description: Waiters point at the AsyncPQ, so it cannot be copied or
+    //              moved.
+    AsyncPQ(const AsyncPQ &) = delete;
+    AsyncPQ &operator=(const AsyncPQ &) = delete;
+
+
+    // Description: Add a new element, and wake a waiter for it.
+    // Runtime: O(push) plus the cost of resuming a waiter
+    void push(const value_type &val) {
+        queue.push(val);
+        wake();
+    }  // push()
+
+
+    // Description: Add every element of a range, and wake waiters for them
+    //              all at once.
+    // Runtime: O(n push) plus the cost of resuming waiters
+    template<typename InputIterator>
+    void push(InputIterator start, InputIterator end) {
+        for (; start != end; ++start) {
+            queue.push(*start);
+        }
+        wake();
+    }  // push()
+
+
+    // Description: Remove and return the most extreme element, or nothing
+    //              if the PQ is empty. Does not wait.
+    // Runtime: O(pop)
+    std::optional<value_type> tryPop() {
+        if (queue.empty()) {
+            return std::nullopt;
+        }
+        std::optional<value_type> item { queue.top() };
+        queue.pop();
+        return item;
+    }  // tryPop()
+
+
+    // Description: Return an awaitable that removes and returns the most
+    //              extreme element, suspending until there is one. Waiters
+    //              with a higher priority are served first.
+    // Runtime: O(1) to create; O(log(waiters)) to suspend
+    PopAwaiter pop_async(Priority priority = 0) { return PopAwaiter { *this, priority }; }
+
+
+    // Description: Get the number of elements waiting to be popped.
+    // Runtime: O(1)
+    [[nodiscard]] std::size_t size() const { return queue.size(); }
+
+
+    // Description: Return true if no element is waiting to be popped.
+    // Runtime: O(1)
+    [[nodiscard]] bool empty() const { return queue.empty(); }
+
+
+    // Description: Get the number of coroutines suspended in pop_async().
+    // Runtime: O(1)
+    [[nodiscard]] std::size_t waiting() const { return waiters.size(); }
+
+
+private:
+    struct Waiter {
+        Priority priority = 0;
+        PopAwaiter *awaiter = nullptr;
+    };
+
+    struct WaiterComp {
+        bool operator()(const Waiter &a, const Waiter &b) const { return a.priority < b.priority; }
+    };
+
+    PQ queue;
+    BinaryPQ<Waiter, WaiterComp> waiters;  // Stable, so equal waiters are FIFO
+    AsyncExecutor *executor;
+    bool wake_posted = false;
+
+    void wake() {
+        if (waiters.empty()) {
+            return;
+        }
+        if (!executor) {
+            dispatch();
+        } else if (!wake_posted) {
+            wake_posted = true;
+            executor->post([this] {
+                wake_posted = false;
+                dispatch();
+            });
+        }
+    }  // wake()
+
+    // Hand out as many elements as there are waiters, best to best, before
+    // resuming any of them, since a resumed waiter may push or wait again.
+    void dispatch() {
+        std::vector<std::coroutine_handle<>> resumed;
+        while (!waiters.empty() && !queue.empty()) {
+            PopAwaiter *awaiter = waiters.top().awaiter;
+            waiters.pop();
+            awaiter->item.emplace(queue.top());
+            queue.pop();
+            resumed.push_back(awaiter->handle);
+        }
+        for (auto handle : resumed) {
+            handle.resume();
+        }
+    }  // dispatch()
+};  // AsyncPQ
+
+#endif  // ASYNCPQ_H
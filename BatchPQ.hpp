@@ -0,0 +1,360 @@
+// Project identifier: 43DE0E0C4C76BFAA6D8C2F5AEAE0518A9C42CF4E
+
+#ifndef BATCHPQ_H
+#define BATCHPQ_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+#include "BinaryPQ.hpp"
+#include "Eecs281PQ.hpp"
+#include "KWayMerge.hpp"
+#include "PQStats.hpp"
+#include "Parallel.hpp"
+#include "Snapshot.hpp"
+
+// A priority queue for batches of work: pushBatch() adds many elements and
+// popBatch() removes the k most extreme, each spread over several threads.
+//
+// The elements are dealt round-robin over one BinaryPQ shard per thread.
+// pushBatch() pushes each shard's share of a batch on its own thread.
+// popBatch() pops a little more than k / shards from every shard at once,
+// merges the runs, and keeps the first k; a shard whose next element
+// would still have made the cut is asked for twice as many more and the merge
+// is redone, which random or round-robin input almost never needs. What
+// was popped beyond the k goes back round-robin.
+//
+// Single push(), pop() and top() work as well, with top() looking at the
+// top of every shard. Threads are only used for batches of at least
+// min_size elements (see ParallelOptions); smaller ones run on the calling
+// thread. The threads are started once, on first use, and then wait
+// between batches, since a batch of a few dozen elements costs less than
+// starting a thread.
+template<typename TYPE, typename COMP_FUNCTOR = std::less<TYPE>>
+class BatchPQ : public Eecs281PQ<TYPE, COMP_FUNCTOR>, public PQCounters {
+    // This is a way to refer to the base class object.
+    using BaseClass = Eecs281PQ<TYPE, COMP_FUNCTOR>;
+    using Shard = BinaryPQ<TYPE, COMP_FUNCTOR>;
+
+public:
+    // Description: Construct an empty PQ with an optional comparison
+    //              functor, and a shard for each of parallel.threads.
+    // Runtime: O(p) where p is the number of shards.
+    explicit BatchPQ(COMP_FUNCTOR comp = COMP_FUNCTOR(), ParallelOptions parallel = ParallelOptions())
+        : BaseClass { comp }
+        , parallelism { parallel }
+        , shards(std::max(1u, parallel.threads), Shard { comp }) {}
+
+
+    // Description: Construct a PQ out of an iterator range with an optional
+    //              comparison functor, building the shards on up to
+    //              parallel.threads threads.
+    // Runtime: O(n) where n is number of elements in range.
+    template<typename InputIterator>
+    BatchPQ(InputIterator start, InputIterator end, COMP_FUNCTOR comp = COMP_FUNCTOR(),
+            ParallelOptions parallel = ParallelOptions())
+        : BatchPQ { comp, parallel } {
+        std::vector<TYPE> elements { start, end };
+        build(elements);
+    }  // BatchPQ()
+
+
+    // Description: Destructor doesn't need any code, the shards will be
+    //              destroyed automatically.
+    virtual ~BatchPQ() = default;
+
+
+    // Description: Copy and move don't need any code either.
+    BatchPQ(const BatchPQ &) = default;
+    BatchPQ(BatchPQ &&) noexcept = default;
+    BatchPQ &operator=(const BatchPQ &) = default;
+    BatchPQ &operator=(BatchPQ &&) noexcept = default;
+
+
+    // Description: Assumes that all elements are out of order and rebuilds
+    //              every shard, each on its own thread if the PQ is large
+    //              enough.
+    // Runtime: O(n)
+    virtual void updatePriorities() {
+        this->countUpdate();
+        forEachShard(count, [this](std::size_t s) { shards[s].updatePriorities(); });
+    }  // updatePriorities()
+
+
+    // Description: Set the number of shards to parallel.threads and how
+    //              large a batch must be to use threads, redealing the
+    //              elements if the number of shards changes.
+    // Runtime: O(n) if the number of shards changes, O(1) otherwise.
+    void setParallelism(ParallelOptions parallel) {
+        parallelism = parallel;
+        if (shards.size() != std::max(1u, parallel.threads)) {
+            std::vector<TYPE> elements = gather();
+            shards.assign(std::max(1u, parallel.threads), Shard { this->compare });
+            build(elements);
+        }
+    }  // setParallelism()
+
+
+    // Description: Add a new element to the PQ, in the next shard in turn.
+    // Runtime: O(log(n))
+    virtual void push(const TYPE &val) {
+        shards[next_shard].push(val);
+        advance(1);
+        ++count;
+    }  // push()
+
+
+    // Description: Add the elements of [first, last) to the PQ, each shard
+    //              pushing its share on its own thread if the batch is
+    //              large enough.
+    // Runtime: O(m log(n)) work, where m is the size of the batch.
+    template<typename RandomIt>
+    void pushBatch(RandomIt first, RandomIt last) {
+        auto m = static_cast<std::size_t>(last - first);
+        std::size_t p = shards.size();
+        std::size_t start = next_shard;
+        // Element i goes to shard (start + i) % p, as if pushed one by one.
+        forEachShard(m, [&](std::size_t s) {
+            for (std::size_t i = (s + p - start) % p; i < m; i += p) {
+                shards[s].push(first[static_cast<std::ptrdiff_t>(i)]);
+            }
+        });
+        advance(m);
+        count += m;
+    }  // pushBatch()
+
+
+    // Description: Remove the most extreme (defined by 'compare') element
+    //              from the PQ.
+    // Runtime: O(p + log(n))
+    virtual void pop() {
+        if (empty()) {
+            return;
+        }
+        shards[extreme_shard()].pop();
+        --count;
+    }  // pop()
+
+
+    // Description: Remove the k most extreme elements (or all of them, if
+    //              there are fewer) and write them to out, most extreme
+    //              first, with each shard popping on its own thread if k is
+    //              large enough. Returns the end of the output.
+    // Runtime: O(k log(n)) work, about O((k / p) log(n) + k log(p)) time
+    //          on p threads.
+    template<typename OutputIterator>
+    OutputIterator popBatch(std::size_t k, OutputIterator out) {
+        k = std::min(k, count);
+        if (k == 0) {
+            return out;
+        }
+        std::size_t p = shards.size();
+        // A share of k, plus enough slack that uneven shards rarely fall
+        // short of it.
+        std::size_t share = k / p;
+        std::size_t slack = 2 * static_cast<std::size_t>(std::sqrt(static_cast<double>(share))) + 1;
+        std::vector<std::size_t> quotas(p, share + slack);
+        std::vector<std::vector<TYPE>> runs(p);
+        std::vector<TYPE> merged;
+        for (;;) {
+            forEachShard(k, [&](std::size_t s) {
+                while (runs[s].size() < quotas[s] && !shards[s].empty()) {
+                    runs[s].push_back(shards[s].top());
+                    shards[s].pop();
+                }
+            });
+            merge_runs(runs, merged);
+            if (!raise_quotas(k, merged, quotas)) {
+                break;
+            }
+        }
+
+        count -= merged.size();
+        auto cut = merged.begin() + static_cast<std::ptrdiff_t>(k);
+        out = std::move(merged.begin(), cut, out);
+        this->countMoves(k);
+        pushBatch(cut, merged.end());
+        return out;
+    }  // popBatch()
+
+
+    // Description: Return the most extreme (defined by 'compare') element.
+    // Runtime: O(p)
+    virtual const TYPE &top() const { return shards[extreme_shard()].top(); }
+
+
+    // Description: Get the number of elements in the PQ.
+    // Runtime: O(1)
+    [[nodiscard]] virtual std::size_t size() const { return count; }
+
+
+    // Description: Return true if the PQ contains no elements.
+    // Runtime: O(1)
+    [[nodiscard]] virtual bool empty() const { return count == 0; }
+
+
+    // Description: Return the number of shards.
+    // Runtime: O(1)
+    [[nodiscard]] std::size_t shardCount() const { return shards.size(); }
+
+
+    // Description: Get the counts of this PQ and all its shards since
+    //              construction or the last resetStats(). updates counts
+    //              the calls to this PQ's updatePriorities(), not the
+    //              shards'.
+    // Runtime: O(p)
+    [[nodiscard]] PQStats stats() const {
+        PQStats total = PQCounters::stats();
+        for (const Shard &shard : shards) {
+            PQStats values = shard.stats();
+            total.compares += values.compares;
+            total.copies += values.copies;
+            total.moves += values.moves;
+            total.allocations += values.allocations;
+            total.sifts += values.sifts;
+            total.sift_levels += values.sift_levels;
+        }
+        return total;
+    }  // stats()
+
+
+    // Description: Zero the counts of this PQ and all its shards.
+    // Runtime: O(p)
+    void resetStats() {
+        PQCounters::resetStats();
+        for (Shard &shard : shards) {
+            shard.resetStats();
+        }
+    }  // resetStats()
+
+
+    // Description: Write the PQ to os as a binary snapshot (see
+    //              Snapshot.hpp), as an unordered list of the elements of
+    //              every shard. TYPE must be trivially copyable.
+    // Runtime: O(n)
+    void save(std::ostream &os) const {
+        std::vector<TYPE> elements = gather();
+        writeSnapshotHeader<TYPE>(os, elements.size(), SnapshotLayout::Unordered);
+        writeSnapshotElements(os, elements.data(), elements.size());
+    }  // save()
+
+
+    // Description: Replace the contents of the PQ with a snapshot read from
+    //              is, of any layout, dealt over the shards.
+    // Runtime: O(n)
+    void load(std::istream &is) {
+        SnapshotHeader header = readSnapshotHeader<TYPE>(is);
+        std::vector<TYPE> elements(header.count);
+        readSnapshotElements(is, elements.data(), elements.size());
+        build(elements);
+    }  // load()
+
+
+private:
+    ParallelOptions parallelism;
+    std::vector<Shard> shards;
+    std::size_t count = 0;
+    std::size_t next_shard = 0;  // Where the next push() goes
+    WorkerPool workers;
+
+    // Call func(s) for every shard, each on its own thread if an operation
+    // on n elements is large enough for threads.
+    template<typename Func>
+    void forEachShard(std::size_t n, Func func) {
+        if (parallelism.useThreads(n)) {
+            workers.run(shards.size(), parallelism.threads, func);
+        } else {
+            for (std::size_t s = 0; s < shards.size(); ++s) {
+                func(s);
+            }
+        }
+    }
+
+    void advance(std::size_t pushes) { next_shard = (next_shard + pushes) % shards.size(); }
+
+    // The non-empty shard with the most extreme top, the first of any
+    // that tie. Requires a non-empty PQ.
+    std::size_t extreme_shard() const {
+        auto less = this->counted(this->compare);
+        std::size_t best = shards.size();
+        for (std::size_t s = 0; s < shards.size(); ++s) {
+            if (!shards[s].empty() && (best == shards.size() || less(shards[best].top(), shards[s].top()))) {
+                best = s;
+            }
+        }
+        return best;
+    }
+
+    // Orders the elements most extreme first, for merging the runs.
+    struct Before {
+        const BatchPQ *pq;
+        bool operator()(const TYPE &a, const TYPE &b) const { return pq->counted(pq->compare)(b, a); }
+    };
+
+    // Merge the runs, each most extreme first, into merged, emptying them.
+    void merge_runs(std::vector<std::vector<TYPE>> &runs, std::vector<TYPE> &merged) {
+        using RunIt = std::move_iterator<typename std::vector<TYPE>::iterator>;
+        std::vector<TYPE> previous = std::move(merged);
+        std::vector<MergeRun<RunIt>> ranges;
+        ranges.emplace_back(std::make_move_iterator(previous.begin()), std::make_move_iterator(previous.end()));
+        for (auto &run : runs) {
+            ranges.emplace_back(std::make_move_iterator(run.begin()), std::make_move_iterator(run.end()));
+        }
+        merged.clear();
+        kWayMerge(std::move(ranges), std::back_inserter(merged), Before { this });
+        this->countMoves(merged.size());
+        for (auto &run : runs) {
+            run.clear();
+        }
+    }
+
+    // Double the quota of every shard that could still hold one of the k
+    // most extreme elements, and return true if any was raised. A shard
+    // that is not empty used all of its quota.
+    bool raise_quotas(std::size_t k, const std::vector<TYPE> &merged, std::vector<std::size_t> &quotas) {
+        auto less = this->counted(this->compare);
+        bool raised = false;
+        for (std::size_t s = 0; s < shards.size(); ++s) {
+            if (shards[s].empty()) {
+                continue;
+            }
+            if (merged.size() < k || less(merged[k - 1], shards[s].top())) {
+                quotas[s] *= 2;
+                raised = true;
+            }
+        }
+        return raised;
+    }
+
+    // Every element, in no particular order.
+    std::vector<TYPE> gather() const {
+        std::vector<TYPE> elements;
+        elements.reserve(count);
+        for (const Shard &shard : shards) {
+            shard.forEachElement([&elements](const TYPE &elt) { elements.push_back(elt); });
+        }
+        return elements;
+    }
+
+    // Replace the contents with the elements, dealt round-robin and each
+    // shard built on its own thread if there are enough of them.
+    void build(const std::vector<TYPE> &elements) {
+        std::size_t p = shards.size();
+        forEachShard(elements.size(), [&](std::size_t s) {
+            std::vector<TYPE> share;
+            share.reserve(elements.size() / p + 1);
+            for (std::size_t i = s; i < elements.size(); i += p) {
+                share.push_back(elements[i]);
+            }
+            shards[s] = Shard { share.begin(), share.end(), this->compare };
+        });
+        count = elements.size();
+        next_shard = count % p;
+    }
+};  // BatchPQ
+
+#endif  // BATCHPQ_H
@@ -6,32 +6,52 @@
 
 #include <algorithm>
 
+#include "Allocator.hpp"
 #include "Eecs281PQ.hpp"
+#include "HeapSift.hpp"
+#include "PQStats.hpp"
+#include "Parallel.hpp"
+#include "Snapshot.hpp"
+#include "Stable.hpp"
+#include "Tombstones.hpp"
 
 using namespace std;
 
 // A specialized version of the priority queue ADT implemented as a binary heap.
-template<typename TYPE, typename COMP_FUNCTOR = std::less<TYPE>>
-class BinaryPQ : public Eecs281PQ<TYPE, COMP_FUNCTOR> {
+template<typename TYPE, typename COMP_FUNCTOR = std::less<TYPE>, typename ALLOCATOR = std::allocator<TYPE>>
+class BinaryPQ : public Eecs281PQ<TYPE, COMP_FUNCTOR>, public PQCounters {
     // This is a way to refer to the base class object.
     using BaseClass = Eecs281PQ<TYPE, COMP_FUNCTOR>;
 
 public:
-    // Description: Construct an empty PQ with an optional comparison functor.
+    // Refers to an element pushed with pushHandle(), for use with erase().
+    using Handle = Tombstones::Handle;
+
+    // Description: Construct an empty PQ with an optional comparison functor
+    //              and allocator.
     // Runtime: O(1)
-    explicit BinaryPQ(COMP_FUNCTOR comp = COMP_FUNCTOR())
-        : BaseClass { comp } {
+    explicit BinaryPQ(COMP_FUNCTOR comp = COMP_FUNCTOR(), const ALLOCATOR &alloc = ALLOCATOR())
+        : BaseClass { comp }
+        , data(alloc)
+        , handles(alloc)
+        , sequence(alloc) {
             this->compare = comp;
             data.push_back(TYPE());
     }  // BinaryPQ
 
 
     // Description: Construct a PQ out of an iterator range with an optional
-    //              comparison functor.
+    //              comparison functor, and optionally heapify it on several
+    //              threads and allocate through alloc.
     // Runtime: O(n) where n is number of elements in range.
     template<typename InputIterator>
-    BinaryPQ(InputIterator start, InputIterator end, COMP_FUNCTOR comp = COMP_FUNCTOR())
-        : BaseClass { comp } {
+    BinaryPQ(InputIterator start, InputIterator end, COMP_FUNCTOR comp = COMP_FUNCTOR(),
+             ParallelOptions parallel = ParallelOptions(), const ALLOCATOR &alloc = ALLOCATOR())
+        : BaseClass { comp }
+        , data(alloc)
+        , handles(alloc)
+        , parallelism { parallel }
+        , sequence(alloc) {
             data.push_back(TYPE());
             this->compare = comp; 
             data.insert(data.end(), start, end);
@@ -59,27 +79,233 @@ public:
 
 
     // Description: Assumes that all elements inside the heap are out of order and
-    //              'rebuilds' the heap by fixing the heap invariant.
+    //              'rebuilds' the heap by fixing the heap invariant.  Large
+    //              heaps are rebuilt on several threads if setParallelism()
+    //              allows it.
     // Runtime: O(n)
     virtual void updatePriorities() {
-        size_t i = (data.size() - 1)/2;
-        while(i >= 1){
-            fix_down(i);
-            i--;
+        this->countUpdate();
+        if (parallelism.useThreads(size())) {
+            parallel_heapify();
+        } else {
+            size_t i = (data.size() - 1)/2;
+            while(i >= 1){
+                fix_down(i);
+                i--;
+            }
         }
+        purge();
         // TODO: Implement this function.
     }  // updatePriorities()
 
 
+    // Description: Set how many threads updatePriorities() may use, and the
+    //              heap size below which it stays serial.
+    void setParallelism(ParallelOptions parallel) { parallelism = parallel; }
+
+
+    // Description: Turn stable mode on or off. In stable mode, elements that
+    //              compare equal are popped in the order they were pushed,
+    //              at the cost of a 32-bit insertion number per element.
+    //              Elements already in the heap count as pushed in their
+    //              current heap order. The live numbers are renumbered once
+    //              limit elements have been numbered; only tests need
+    //              anything but the default.
+    // Runtime: O(n)
+    void setStable(bool stable, InsertionOrder::Sequence limit = InsertionOrder::kMaxLimit) {
+        order.setLimit(limit);
+        if (stable == order.enabled()) {
+            return;
+        }
+        if (stable) {
+            number_slots();
+        } else {
+            sequence.clear();
+            order.enable(false);
+        }
+    }  // setStable()
+
+
     // Description: Add a new element to the PQ.
     // Runtime: O(log(n))
     virtual void push(const TYPE &val) {
         // TODO: Implement this function.
         data.push_back(val);
+        this->countCopies();
+        if (!handles.empty()) {
+            handles.push_back(tombstones.acquire());
+        }
+        stamp();
         fix_up(data.size() - 1);
     }  // push()
 
 
+    // Description: Add a new element to the PQ and return a handle that can
+    //              later be passed to erase(). The handle stays valid until
+    //              its element leaves the PQ through pop() or erase().
+    // Runtime: O(log(n))
+    Handle pushHandle(const TYPE &val) {
+        track();
+        Handle handle = tombstones.acquire();
+        data.push_back(val);
+        this->countCopies();
+        handles.push_back(handle);
+        stamp();
+        fix_up(data.size() - 1);
+        return handle;
+    }  // pushHandle()
+
+
+    // Description: Lazily erase the element referred to by handle. It is only
+    //              marked dead here; it is discarded when it reaches the top,
+    //              or when the fraction of dead elements passes the
+    //              compaction threshold and the heap is rebuilt.
+    // Runtime: O(1), plus the amortized cost of discarding the element.
+    void erase(Handle handle) {
+        if (!tombstones.kill(handle)) {
+            return;
+        }
+        purge();
+        if (tombstones.shouldCompact(data.size() - 1)) {
+            compact();
+        }
+    }  // erase()
+
+
+    // Description: Discard every dead element and rebuild the heap.
+    // Runtime: O(n)
+    void compact() {
+        if (handles.empty()) {
+            return;
+        }
+        size_t live = 1;
+        for (size_t i = 1; i < data.size(); ++i) {
+            if (tombstones.dead(handles[i])) {
+                tombstones.release(handles[i]);
+                continue;
+            }
+            if (live != i) {
+                data[live] = std::move(data[i]);
+                this->countMoves();
+                handles[live] = handles[i];
+                if (order.enabled()) {
+                    sequence[live] = sequence[i];
+                }
+            }
+            ++live;
+        }
+        data.erase(data.begin() + static_cast<std::ptrdiff_t>(live), data.end());
+        handles.resize(live);
+        if (order.enabled()) {
+            sequence.resize(live);
+        }
+        BinaryPQ::updatePriorities();
+    }  // compact()
+
+
+    // Description: Set the fraction of stored elements that may be dead
+    //              before erase() or pop() compacts the heap.
+    void setCompactionThreshold(double fraction) { tombstones.setThreshold(fraction); }
+
+
+    // Description: Get the number of erased elements still stored.
+    // Runtime: O(1)
+    [[nodiscard]] std::size_t tombstoneCount() const { return tombstones.count(); }
+
+
+    // Description: Get the fraction of stored elements that are dead.
+    // Runtime: O(1)
+    [[nodiscard]] double tombstoneRatio() const { return tombstones.ratio(data.size() - 1); }
+
+
+    // Description: Make room for n elements in all, so that pushing up to
+    //              that many does not reallocate.
+    // Runtime: O(n)
+    void reserve(std::size_t n) {
+        data.reserve(n + 1);
+        if (!handles.empty()) {
+            handles.reserve(n + 1);
+        }
+        if (order.enabled()) {
+            sequence.reserve(n + 1);
+        }
+    }  // reserve()
+
+
+    // Description: Get the number of elements the PQ can hold before it
+    //              reallocates.
+    // Runtime: O(1)
+    [[nodiscard]] std::size_t capacity() const { return data.capacity() - 1; }
+
+
+    // Description: Return unused capacity to the allocator.
+    // Runtime: O(n)
+    void shrink_to_fit() {
+        data.shrink_to_fit();
+        handles.shrink_to_fit();
+        sequence.shrink_to_fit();
+    }  // shrink_to_fit()
+
+
+    // Description: Get a copy of the allocator the PQ allocates through.
+    // Runtime: O(1)
+    ALLOCATOR get_allocator() const { return data.get_allocator(); }
+
+
+    // Description: Call func(elt) for every element, in no particular
+    //              order, without copying them out of the heap.
+    // Runtime: O(n)
+    template<typename Func>
+    void forEachElement(Func func) const {
+        for (size_t i = 1; i < data.size(); ++i) {
+            if (handles.empty() || !tombstones.dead(handles[i])) {
+                func(data[i]);
+            }
+        }
+    }  // forEachElement()
+
+
+    // Description: Write the PQ to os as a binary snapshot (see Snapshot.hpp).
+    //              TYPE must be trivially copyable.
+    //              The heap array is written as-is, unless erased elements
+    //              have to be left out.
+    // Runtime: O(n)
+    void save(std::ostream &os) const {
+        if (tombstones.count() == 0) {
+            writeSnapshotHeader<TYPE>(os, size(), SnapshotLayout::Heap);
+            writeSnapshotElements(os, data.data() + 1, size());
+            return;
+        }
+        std::vector<TYPE> live;
+        live.reserve(size());
+        forEachElement([&live](const TYPE &elt) { live.push_back(elt); });
+        writeSnapshotHeader<TYPE>(os, live.size(), SnapshotLayout::Unordered);
+        writeSnapshotElements(os, live.data(), live.size());
+    }  // save()
+
+
+    // Description: Replace the contents of the PQ with a snapshot read from
+    //              is. A heap-ordered snapshot is used without re-heapifying;
+    //              any other layout is rebuilt. Handles from before the load
+    //              are no longer valid. In stable mode, the loaded elements
+    //              count as pushed in their stored order.
+    // Runtime: O(n)
+    void load(std::istream &is) {
+        SnapshotHeader header = readSnapshotHeader<TYPE>(is);
+        std::vector<TYPE, ALLOCATOR> loaded(header.count + 1, data.get_allocator());
+        readSnapshotElements(is, loaded.data() + 1, header.count);
+        data.swap(loaded);
+        handles.clear();
+        tombstones.clear();
+        if (order.enabled()) {
+            number_slots();
+        }
+        if (header.layout != SnapshotLayout::Heap) {
+            BinaryPQ::updatePriorities();
+        }
+    }  // load()
+
+
     // Description: Remove the most extreme (defined by 'compare') element
     //              from the PQ.
     // Note: We will not run tests on your code that would require it to pop
@@ -87,14 +313,40 @@ public:
     // familiar with them, you do not need to use exceptions in this project.
     // Runtime: O(log(n))
     virtual void pop() {
-        data[1] = data.back();
-        data.pop_back();
-        if(data.size() > 2){
-            fix_down(1);
+        remove_top();
+        purge();
+        if (tombstones.shouldCompact(data.size() - 1)) {
+            compact();
         }
     }  
 
 
+    // Description: Replace the most extreme element with val. Same as pop()
+    //              followed by push(val), but sifts down once instead of
+    //              sifting down and then up, which suits merging sorted
+    //              runs, where every pop is followed by a push.
+    // Runtime: O(log(n))
+    void replaceTop(const TYPE &val) {
+        if (data.size() == 1) {
+            BinaryPQ::push(val);
+            return;
+        }
+        if (!handles.empty()) {
+            tombstones.release(handles[1]);
+            handles[1] = tombstones.acquire();
+        }
+        if (order.enabled()) {
+            stamp();
+            sequence[1] = sequence.back();
+            sequence.pop_back();
+        }
+        data[1] = val;
+        this->countCopies();
+        fix_down(1);
+        purge();
+    }  // replaceTop()
+
+
     // Description: Return the most extreme (defined by 'compare') element of
     //              the PQ. This should be a reference for speed. It MUST
     //              be const because we cannot allow it to be modified, as
@@ -113,7 +365,7 @@ public:
     [[nodiscard]] virtual std::size_t size() const {
         // TODO: Implement this function. Might be very simple,
         // depending on your implementation.
-        return data.size() - 1;  
+        return data.size() - 1 - tombstones.count();
     }  // size()
 
 
@@ -122,7 +374,7 @@ public:
     [[nodiscard]] virtual bool empty() const {
         // TODO: Implement this function. Might be very simple,
         // depending on your implementation.
-        if(data.size() - 1 == 0){
+        if(size() == 0){
             return true; 
         } else {
             return false;
@@ -132,32 +384,161 @@ public:
 
 
 private:
+    using Sequence = InsertionOrder::Sequence;
+
     // Note: This vector *must* be used for your PQ implementation.
-    std::vector<TYPE> data;
-    
-    template <typename T>
+    std::vector<TYPE, ALLOCATOR> data;
+
+    // Handle of the element at the same index of data. Stays empty until
+    // the first pushHandle(), so untracked heaps never pay for it.
+    AllocVector<Handle, ALLOCATOR> handles;
+    Tombstones tombstones;
+    ParallelOptions parallelism;
+
+    // Insertion number of the element at the same index of data, in stable
+    // mode only. Slot indices number a heap consistently with ties going to
+    // the lower number, since a parent's index is below its children's.
+    AllocVector<Sequence, ALLOCATOR> sequence;
+    InsertionOrder order;
+
+    // Whether the element in slot a has lower priority than the one in slot
+    // b. In stable mode, ties go to the element pushed first.
+    bool lower(size_t a, size_t b) const {
+        const auto &less = this->counted(this->compare);
+        if (!order.enabled()) {
+            return less(data[a], data[b]);
+        }
+        if (less(data[a], data[b])) {
+            return true;
+        }
+        return !less(data[b], data[a]) && InsertionOrder::later(sequence[a], sequence[b]);
+    }
+
+    // Number every element by its slot, and start stable mode.
+    void number_slots() {
+        sequence.clear();
+        for (size_t i = 0; i < data.size(); ++i) {
+            sequence.push_back(static_cast<Sequence>(i));
+        }
+        order.enable(true, static_cast<Sequence>(data.size()));
+    }
+
+    // Number the element just pushed, in stable mode.
+    void stamp() {
+        if (!order.enabled()) {
+            return;
+        }
+        if (order.exhausted()) {
+            std::vector<Sequence *> live;
+            for (size_t i = 1; i < sequence.size(); ++i) {
+                live.push_back(&sequence[i]);
+            }
+            order.renumber(live);
+        }
+        sequence.push_back(order.stamp());
+    }
+
+    // Swap two heap slots, keeping their handles in step when tracked.
+    void swap_slots(size_t a, size_t b) {
+        std::swap(data[a], data[b]);
+        this->countMoves(3);
+        if (!handles.empty()) {
+            std::swap(handles[a], handles[b]);
+        }
+        if (order.enabled()) {
+            std::swap(sequence[a], sequence[b]);
+        }
+    }
+
+    // Start tracking handles, giving one to every element already stored.
+    void track() {
+        if (handles.empty()) {
+            handles.push_back(0);
+        }
+        while (handles.size() < data.size()) {
+            handles.push_back(tombstones.acquire());
+        }
+    }
+
+    // Remove the root regardless of whether it is live or dead.
+    void remove_top() {
+        if (!handles.empty()) {
+            tombstones.release(handles[1]);
+            handles[1] = handles.back();
+            handles.pop_back();
+        }
+        if (order.enabled()) {
+            sequence[1] = sequence.back();
+            sequence.pop_back();
+        }
+        data[1] = data.back();
+        this->countCopies();
+        data.pop_back();
+        if(data.size() > 2){
+            fix_down(1);
+        }
+    }
+
+    // Discard dead elements until the root is live, so top() never sees one.
+    void purge() {
+        while (data.size() > 1 && !handles.empty() && tombstones.dead(handles[1])) {
+            remove_top();
+        }
+    }
+
+    // Floyd's heapify on several threads. The subtrees rooted at one level
+    // are disjoint, so each thread heapifies a block of them independently;
+    // the few levels above are then fixed on this thread.
+    void parallel_heapify() {
+        size_t heap_size = data.size() - 1;
+        size_t first_root = 1;
+        while (first_root < 4 * static_cast<size_t>(parallelism.threads)) {
+            first_root *= 2;
+        }
+        size_t roots_end = std::min(2 * first_root, heap_size + 1);
+        if (first_root < roots_end) {
+            parallelFor(roots_end - first_root, parallelism.threads,
+                        [this, first_root](size_t i) { heapify_subtree(first_root + i); });
+        }
+        for (size_t i = std::min(first_root, heap_size + 1) - 1; i >= 1; --i) {
+            fix_down(i);
+        }
+    }
+
+    // Floyd's heapify restricted to the subtree under root, level by level
+    // from its deepest level up.
+    void heapify_subtree(size_t root) {
+        size_t heap_size = data.size() - 1;
+        size_t level = root;
+        size_t width = 1;
+        while (2 * level <= heap_size) {
+            level *= 2;
+            width *= 2;
+        }
+        while (true) {
+            for (size_t i = std::min(level + width, heap_size + 1); i-- > level;) {
+                fix_down(i);
+            }
+            if (level == root) {
+                break;
+            }
+            level /= 2;
+            width /= 2;
+        }
+    }
+
     void fix_up(size_t index) {
-	    while (index > 1 && this->compare(data[index / 2], data[index])) {
-		    swap(data[index], data[index / 2]);
-		    index /= 2;
-	    }
+        this->countSift(heapSiftUp(
+            index, [this](size_t a, size_t b) { return lower(a, b); },
+            [this](size_t a, size_t b) { swap_slots(a, b); }));
     }
 
-    template <typename T> 
+    // Sift down with the shared heapSiftDown(), which prefetches the
+    // grandchildren and picks the child without a branch.
     void fix_down(size_t index) {
-	    size_t heap_size = data.size() - 1;
-	    while (2 * index <= heap_size) {
-		    size_t larger_child = 2 * index;
-		    if (larger_child < heap_size &&
-			    this->compare(data[larger_child], data[larger_child + 1])) {
-		        ++larger_child;
-		    }
-		    if (this->compare(data[larger_child], data[index])) {
-			    break;
-		    }
-		std::swap(data[index], data[larger_child]);
-		index = larger_child;
-	    }
+        this->countSift(heapSiftDown(
+            data.data(), data.size() - 1, index, [this](size_t a, size_t b) { return lower(a, b); },
+            [this](size_t a, size_t b) { swap_slots(a, b); }));
     }
 
 
@@ -171,4 +552,9 @@ private:
 };  // BinaryPQ
 
 
+// A BinaryPQ that allocates through a std::pmr::memory_resource.
+template<typename TYPE, typename COMP_FUNCTOR = std::less<TYPE>>
+using PmrBinaryPQ = BinaryPQ<TYPE, COMP_FUNCTOR, std::pmr::polymorphic_allocator<TYPE>>;
+
+
 #endif  // BINARYPQ_H
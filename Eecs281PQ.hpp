@@ -7,6 +7,14 @@
 #include <iterator>
 #include <vector>
 
+// A stateless comparator takes no space in a PQ, where the compiler
+// supports it.
+#if __has_cpp_attribute(no_unique_address)
+#define PQ_NO_UNIQUE_ADDRESS [[no_unique_address]]
+#else
+#define PQ_NO_UNIQUE_ADDRESS
+#endif
+
 // A simple interface that implements a generic priority queue.
 // Runtime specifications assume constant time comparison and copying.
 template<typename TYPE, typename COMP_FUNCTOR = std::less<TYPE>>
@@ -60,7 +68,7 @@ protected:
     // this->compare(thing1, thing2)
     // With the default compare function (std::less), this will
     // tell you if Thing1 is lower priority than Thing2.
-    COMP_FUNCTOR compare;  // NOLINT: comparator stored in base class
+    PQ_NO_UNIQUE_ADDRESS COMP_FUNCTOR compare;  // NOLINT: comparator stored in base class
 };  // Eecs281PQ
 
 
@@ -0,0 +1,365 @@
+// Project identifier: 43DE0E0C4C76BFAA6D8C2F5AEAE0518A9C42CF4E
+
+#ifndef EXTERNALPQ_H
+#define EXTERNALPQ_H
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <unistd.h>
+
+#include "BinaryPQ.hpp"
+#include "Eecs281PQ.hpp"
+
+// Memory budget of an ExternalPQ. It holds about buffer_bytes plus
+// block_bytes per run of elements in RAM. Fewer than max_runs runs are
+// kept per level, and there are about log_max_runs(n / buffer) levels.
+struct ExternalPQOptions {
+    std::string dir = "/tmp";                // Where run files are created
+    std::size_t buffer_bytes = 64u << 20u;   // NOLINT: insertion buffer
+    std::size_t block_bytes = 1u << 20u;     // NOLINT: read buffer per run
+    std::size_t max_runs = 64;               // NOLINT: merge fan-in, at least 2
+};
+
+// A priority queue for more elements than fit in memory. New elements go
+// into an in-memory BinaryPQ; when it fills up, it is drained in priority
+// order into a sorted 'run' file on disk. The head of every run sits in a
+// small heap, so the most extreme element is either the top of the buffer
+// or the top of the run heap. Runs are merged by level: a spilled run is at
+// level 0, and when a level holds max_runs runs they are merged into one
+// run at the next level. Older, larger runs are left alone, so every
+// element is rewritten once per level, O(log_max_runs(n / buffer)) times
+// in all, rather than once per merge. Run files are unlinked as soon as
+// they are created, so nothing is left behind on disk if the process dies.
+// TYPE must be trivially copyable, since it is written to disk as raw bytes.
+template<typename TYPE, typename COMP_FUNCTOR = std::less<TYPE>>
+class ExternalPQ : public Eecs281PQ<TYPE, COMP_FUNCTOR> {
+    static_assert(std::is_trivially_copyable<TYPE>::value,
+                  "ExternalPQ writes TYPE to disk as raw bytes");
+
+    // This is a way to refer to the base class object.
+    using BaseClass = Eecs281PQ<TYPE, COMP_FUNCTOR>;
+
+    // The current element of a run, tagged with the run it came from.
+    struct Head {
+        TYPE elt;
+        std::size_t run;
+    };
+
+    struct HeadComp {
+        COMP_FUNCTOR compare;
+        bool operator()(const Head &a, const Head &b) const { return compare(a.elt, b.elt); }
+    };
+
+    class Run;
+
+public:
+    // Description: Construct an empty PQ with an optional comparison functor
+    //              and memory budget.
+    // Runtime: O(1)
+    explicit ExternalPQ(COMP_FUNCTOR comp = COMP_FUNCTOR(), ExternalPQOptions options = ExternalPQOptions())
+        : BaseClass { comp }
+        , options { std::move(options) }
+        , buffer { comp }
+        , heads { HeadComp { comp } } {}
+
+
+    // Description: Construct a PQ out of an iterator range with an optional
+    //              comparison functor and memory budget.
+    // Runtime: O(n log(n)) where n is number of elements in range.
+    template<typename InputIterator>
+    ExternalPQ(InputIterator start, InputIterator end, COMP_FUNCTOR comp = COMP_FUNCTOR(),
+               ExternalPQOptions options = ExternalPQOptions())
+        : ExternalPQ { comp, std::move(options) } {
+        while (start != end) {
+            push(*start);
+            ++start;
+        }
+    }  // ExternalPQ()
+
+
+    // Description: Run files are owned by this PQ, so it cannot be copied.
+    //              The destructor closes (and so frees) every run file.
+    virtual ~ExternalPQ() = default;
+    ExternalPQ(const ExternalPQ &) = delete;
+    ExternalPQ(ExternalPQ &&) noexcept = default;
+    ExternalPQ &operator=(const ExternalPQ &) = delete;
+    ExternalPQ &operator=(ExternalPQ &&) noexcept = default;
+
+
+    // Description: Assumes that all elements are out of order, and re-sorts
+    //              them by pushing every one of them again.
+    // Runtime: O(n log(n)), reading and writing every element once.
+    virtual void updatePriorities() {
+        std::vector<std::unique_ptr<Run>> old_runs;
+        std::swap(old_runs, runs);
+        heads = BinaryPQ<Head, HeadComp> { HeadComp { this->compare } };
+        level_runs.clear();
+
+        BinaryPQ<TYPE, COMP_FUNCTOR> old_buffer { this->compare };
+        std::swap(old_buffer, buffer);
+        count = 0;
+
+        // Qualified calls, so a derived PQ (such as TracedPQ) does not see
+        // these as pushes of its own.
+        for (auto &run : old_runs) {
+            while (run && !run->empty()) {
+                ExternalPQ::push(run->head());
+                run->advance();
+            }
+            run.reset();  // Free each old run as soon as it is consumed
+        }
+        while (!old_buffer.empty()) {
+            ExternalPQ::push(old_buffer.top());
+            old_buffer.pop();
+        }
+    }  // updatePriorities()
+
+
+    // Description: Add a new element to the PQ.
+    // Runtime: Amortized O(log(n)), plus a run written to disk every time
+    //          the buffer fills up.
+    virtual void push(const TYPE &val) {
+        buffer.push(val);
+        ++count;
+        if (buffer.size() * sizeof(TYPE) >= options.buffer_bytes) {
+            spill();
+        }
+    }  // push()
+
+
+    // Description: Remove the most extreme (defined by 'compare') element
+    //              from the PQ.
+    // Runtime: Amortized O(log(n)), plus a block read every block_bytes
+    //          elements of a run.
+    virtual void pop() {
+        if (topIsInRun()) {
+            advance_top();
+        } else {
+            buffer.pop();
+        }
+        --count;
+    }  // pop()
+
+
+    // Description: Return the most extreme (defined by 'compare') element.
+    // Runtime: O(1)
+    virtual const TYPE &top() const { return topIsInRun() ? heads.top().elt : buffer.top(); }
+
+
+    // Description: Get the number of elements in the PQ.
+    // Runtime: O(1)
+    [[nodiscard]] virtual std::size_t size() const { return count; }
+
+
+    // Description: Return true if the PQ is empty.
+    // Runtime: O(1)
+    [[nodiscard]] virtual bool empty() const { return count == 0; }
+
+
+    // Description: Get the number of run files currently on disk.
+    // Runtime: O(1)
+    [[nodiscard]] std::size_t runCount() const { return heads.size(); }
+
+
+    // Description: Get the number of elements written to run files so far,
+    //              by spills and merges together.
+    // Runtime: O(1)
+    [[nodiscard]] std::size_t runWrites() const { return writes; }
+
+
+private:
+    // A sorted run on disk, most extreme element first, read back one block
+    // at a time.
+    class Run {
+    public:
+        Run(const std::string &dir, std::size_t block_size, std::size_t level)
+            : block_size { std::max<std::size_t>(block_size, 1) }
+            , run_level { level } {
+            std::string path = dir + "/ExternalPQ.XXXXXX";
+            int fd = ::mkstemp(path.data());
+            if (fd < 0) {
+                throw std::runtime_error("ExternalPQ: cannot create run file in " + dir);
+            }
+            ::unlink(path.c_str());
+            file = ::fdopen(fd, "w+b");
+            if (!file) {
+                ::close(fd);
+                throw std::runtime_error("ExternalPQ: cannot open run file");
+            }
+        }  // Run()
+
+        ~Run() { std::fclose(file); }
+        Run(const Run &) = delete;
+        Run &operator=(const Run &) = delete;
+
+        // Writing: append elements in order, then finish() to start reading.
+        void append(const TYPE &val) {
+            block.push_back(val);
+            if (block.size() == block_size) {
+                flush();
+            }
+        }  // append()
+
+        void finish() {
+            flush();
+            std::rewind(file);
+            refill();
+        }  // finish()
+
+        // Merge level: 0 for a spilled buffer, one more than its inputs for
+        // a merged run.
+        [[nodiscard]] std::size_t level() const { return run_level; }
+
+        // Reading: head() is valid until advance() moves past the last one.
+        [[nodiscard]] bool empty() const { return pos == block.size(); }
+        [[nodiscard]] const TYPE &head() const { return block[pos]; }
+
+        void advance() {
+            if (++pos == block.size()) {
+                refill();
+            }
+        }  // advance()
+
+    private:
+        std::FILE *file = nullptr;
+        std::size_t block_size;
+        std::size_t run_level;
+        std::vector<TYPE> block;
+        std::size_t pos = 0;
+        std::size_t unread = 0;  // Elements in the file past the block
+
+        void flush() {
+            if (std::fwrite(block.data(), sizeof(TYPE), block.size(), file) != block.size()) {
+                throw std::runtime_error("ExternalPQ: cannot write run file");
+            }
+            unread += block.size();
+            block.clear();
+        }  // flush()
+
+        void refill() {
+            std::size_t n = std::min(block_size, unread);
+            block.resize(n);
+            if (std::fread(block.data(), sizeof(TYPE), n, file) != n) {
+                throw std::runtime_error("ExternalPQ: cannot read run file");
+            }
+            unread -= n;
+            pos = 0;
+        }  // refill()
+    };  // Run
+
+    ExternalPQOptions options;
+    BinaryPQ<TYPE, COMP_FUNCTOR> buffer;
+    std::vector<std::unique_ptr<Run>> runs;
+    BinaryPQ<Head, HeadComp> heads;
+    std::vector<std::size_t> level_runs;  // Runs still open at each level
+    std::size_t count = 0;
+    std::size_t writes = 0;
+
+    [[nodiscard]] bool topIsInRun() const {
+        return !heads.empty() && (buffer.empty() || this->compare(buffer.top(), heads.top().elt));
+    }  // topIsInRun()
+
+    [[nodiscard]] std::unique_ptr<Run> newRun(std::size_t level) const {
+        return std::make_unique<Run>(options.dir, options.block_bytes / sizeof(TYPE), level);
+    }  // newRun()
+
+    // Replace the top of the run heap with the next element of its run, or
+    // remove it and free the run once it has been consumed.
+    void advance_top() {
+        std::size_t index = heads.top().run;
+        Run &run = *runs[index];
+        run.advance();
+        if (run.empty()) {
+            heads.pop();
+            --level_runs[run.level()];
+            runs[index].reset();
+            if (heads.empty()) {
+                runs.clear();
+            }
+        } else {
+            heads.replaceTop(Head { run.head(), index });
+        }
+    }  // advance_top()
+
+    // Start reading a finished run and put its head in the run heap.
+    void addRun(std::unique_ptr<Run> run) {
+        run->finish();
+        if (!run->empty()) {
+            if (level_runs.size() <= run->level()) {
+                level_runs.resize(run->level() + 1);
+            }
+            ++level_runs[run->level()];
+            heads.push(Head { run->head(), runs.size() });
+            runs.push_back(std::move(run));
+        }
+    }  // addRun()
+
+    // Write the buffer out as a new level 0 run, then merge every level
+    // that has filled up, from the lowest.
+    void spill() {
+        auto run = newRun(0);
+        while (!buffer.empty()) {
+            run->append(buffer.top());
+            ++writes;
+            buffer.pop();
+        }
+        addRun(std::move(run));
+
+        std::size_t fan_in = std::max<std::size_t>(options.max_runs, 2);
+        for (std::size_t level = 0; level < level_runs.size() && level_runs[level] >= fan_in; ++level) {
+            mergeLevel(level);
+        }
+    }  // spill()
+
+    // Merge the runs of one level into a single run at the next level,
+    // through a heap of their heads only.
+    void mergeLevel(std::size_t level) {
+        BinaryPQ<Head, HeadComp> merging { HeadComp { this->compare } };
+        for (std::size_t i = 0; i < runs.size(); ++i) {
+            if (runs[i] && runs[i]->level() == level) {
+                merging.push(Head { runs[i]->head(), i });
+            }
+        }
+
+        auto merged = newRun(level + 1);
+        while (!merging.empty()) {
+            std::size_t index = merging.top().run;
+            merged->append(merging.top().elt);
+            ++writes;
+            Run &run = *runs[index];
+            run.advance();
+            if (run.empty()) {
+                merging.pop();
+                runs[index].reset();
+            } else {
+                merging.replaceTop(Head { run.head(), index });
+            }
+        }
+        level_runs[level] = 0;
+
+        rebuildHeads();
+        addRun(std::move(merged));
+    }  // mergeLevel()
+
+    // Drop the runs that have been freed and rebuild the run heap over the
+    // rest, whose heads have not moved.
+    void rebuildHeads() {
+        runs.erase(std::remove(runs.begin(), runs.end(), nullptr), runs.end());
+        std::vector<Head> live;
+        live.reserve(runs.size());
+        for (std::size_t i = 0; i < runs.size(); ++i) {
+            live.push_back(Head { runs[i]->head(), i });
+        }
+        heads = BinaryPQ<Head, HeadComp> { live.begin(), live.end(), HeadComp { this->compare } };
+    }  // rebuildHeads()
+};  // ExternalPQ
+
+#endif  // EXTERNALPQ_H
@@ -0,0 +1,96 @@
+// Project identifier: 43DE0E0C4C76BFAA6D8C2F5AEAE0518A9C42CF4E
+
+#ifndef HEAPSIFT_H
+#define HEAPSIFT_H
+
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+
+#include "Prefetch.hpp"
+
+// Sift operations on a binary heap stored from slot 1 of an array, shared
+// by BinaryPQ and the heaps whose array is not a vector (MappedBinaryPQ,
+// SharedBinaryPQ). The heap is described by its array and two callbacks
+// over slot indices: lower(a, b) is true if slot a has lower priority than
+// slot b, and swap(a, b) exchanges two slots together with anything the
+// caller keeps beside them.
+
+// Description: Move the element in slot index up until its parent does not
+//              have lower priority. Returns the number of levels it moved.
+// Runtime: O(log(index))
+template<typename Lower, typename Swap>
+std::size_t heapSiftUp(std::size_t index, Lower lower, Swap swap) {
+    std::size_t levels = 0;
+    while (index > 1 && lower(index / 2, index)) {
+        swap(index, index / 2);
+        index /= 2;
+        ++levels;
+    }
+    return levels;
+}  // heapSiftUp()
+
+
+// Description: Move the element in slot index down until neither child has
+//              higher priority, in a heap of heap_size elements stored in
+//              slots[1..heap_size]. Returns the number of levels it moved.
+//              The next level is loaded ahead of time: the four
+//              grandchildren are adjacent, so one or two cache lines cover
+//              them whichever child wins. The child is picked without a
+//              branch, which an arithmetic comparison turns into a
+//              conditional add.
+// Runtime: O(log(heap_size))
+template<typename TYPE, typename Lower, typename Swap>
+std::size_t heapSiftDown(const TYPE *slots, std::size_t heap_size, std::size_t index, Lower lower, Swap swap) {
+    std::size_t levels = 0;
+    while (2 * index <= heap_size) {
+        if (4 * index <= heap_size) {
+            prefetchRead(&slots[4 * index]);
+            prefetchRead(&slots[std::min(4 * index + 3, heap_size)]);
+        }
+        std::size_t larger_child = 2 * index;
+        if (larger_child < heap_size) {
+            larger_child += static_cast<std::size_t>(lower(larger_child, larger_child + 1));
+        }
+        if (lower(larger_child, index)) {
+            break;
+        }
+        swap(index, larger_child);
+        index = larger_child;
+        ++levels;
+    }
+    return levels;
+}  // heapSiftDown()
+
+
+// Description: heapSiftUp() on a plain array ordered by compare.
+// Runtime: O(log(index))
+template<typename TYPE, typename COMP_FUNCTOR>
+std::size_t heapSiftUp(TYPE *slots, std::size_t index, const COMP_FUNCTOR &compare) {
+    return heapSiftUp(
+        index, [slots, &compare](std::size_t a, std::size_t b) { return compare(slots[a], slots[b]); },
+        [slots](std::size_t a, std::size_t b) { std::swap(slots[a], slots[b]); });
+}  // heapSiftUp()
+
+
+// Description: heapSiftDown() on a plain array ordered by compare.
+// Runtime: O(log(heap_size))
+template<typename TYPE, typename COMP_FUNCTOR>
+std::size_t heapSiftDown(TYPE *slots, std::size_t heap_size, std::size_t index, const COMP_FUNCTOR &compare) {
+    return heapSiftDown(
+        slots, heap_size, index,
+        [slots, &compare](std::size_t a, std::size_t b) { return compare(slots[a], slots[b]); },
+        [slots](std::size_t a, std::size_t b) { std::swap(slots[a], slots[b]); });
+}  // heapSiftDown()
+
+
+// Description: Floyd's heapify of a plain array ordered by compare.
+// Runtime: O(heap_size)
+template<typename TYPE, typename COMP_FUNCTOR>
+void heapBuild(TYPE *slots, std::size_t heap_size, const COMP_FUNCTOR &compare) {
+    for (std::size_t i = heap_size / 2; i >= 1; --i) {
+        heapSiftDown(slots, heap_size, i, compare);
+    }
+}  // heapBuild()
+
+#endif  // HEAPSIFT_H
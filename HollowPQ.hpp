@@ -0,0 +1,383 @@
+// Project identifier: 43DE0E0C4C76BFAA6D8C2F5AEAE0518A9C42CF4E
+
+#ifndef HOLLOWPQ_H
+#define HOLLOWPQ_H
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "Eecs281PQ.hpp"
+#include "PQStats.hpp"
+#include "Snapshot.hpp"
+
+// A priority queue implemented as a hollow heap (Hansen, Kaplan, Tarjan and
+// Zwick), with the same addNode()/updateElt() handle interface as PairingPQ.
+// Unlike a pairing heap, raising a priority costs O(1) amortized whatever
+// the sequence of operations, and pop() costs O(log(n)) amortized.
+//
+// updateElt() does not move the element within the heap: it moves it to a
+// new cell and leaves the old cell behind, hollow, to be cleaned up by a
+// later pop(). The Node handed out by addNode() is the element itself, so
+// it stays put until it is popped.
+template<typename TYPE, typename COMP_FUNCTOR = std::less<TYPE>>
+class HollowPQ : public Eecs281PQ<TYPE, COMP_FUNCTOR>, public PQCounters {
+    // This is a way to refer to the base class object.
+    using BaseClass = Eecs281PQ<TYPE, COMP_FUNCTOR>;
+
+    struct Cell;
+
+public:
+    // An element of the heap, as returned by addNode().
+    class Node {
+    public:
+        // Description: Custom constructor that creates a node containing
+        //              the given value.
+        explicit Node(const TYPE &val)
+            : elt { val } {}
+
+        // Description: Allows access to the element at that Node's position.
+        // Runtime: O(1)
+        const TYPE &getElt() const { return elt; }
+        const TYPE &operator*() const { return elt; }
+
+        friend HollowPQ;
+
+    private:
+        TYPE elt;
+        Cell *cell = nullptr;  // The cell currently holding this element
+    };  // Node
+
+
+    // Description: Construct an empty hollow heap with an optional
+    //              comparison functor.
+    // Runtime: O(1)
+    explicit HollowPQ(COMP_FUNCTOR comp = COMP_FUNCTOR())
+        : BaseClass { comp } {}
+
+
+    // Description: Construct a hollow heap out of an iterator range with an
+    //              optional comparison functor.
+    // Runtime: O(n) where n is number of elements in range.
+    template<typename InputIterator>
+    HollowPQ(InputIterator start, InputIterator end, COMP_FUNCTOR comp = COMP_FUNCTOR())
+        : BaseClass { comp } {
+        while (start != end) {
+            addNode(*start);
+            ++start;
+        }
+    }  // HollowPQ()
+
+
+    // Description: Copy constructor. The copy has no hollow cells.
+    // Runtime: O(n)
+    HollowPQ(const HollowPQ &other)
+        : BaseClass { other.compare }
+        , PQCounters { other } {
+        other.forEachCell([this](Cell *cell) {
+            if (cell->item) {
+                addNode(cell->item->elt);
+            }
+        });
+    }  // HollowPQ()
+
+
+    // Description: Copy assignment operator.
+    // Runtime: O(n)
+    HollowPQ &operator=(const HollowPQ &rhs) {
+        if (this != &rhs) {
+            HollowPQ copy { rhs };
+            *this = std::move(copy);
+        }
+        return *this;
+    }  // operator=()
+
+
+    // Description: Move constructor and assignment operators reuse the
+    //              cells and nodes.
+    HollowPQ(HollowPQ &&other) noexcept
+        : BaseClass { std::move(other) }
+        , PQCounters { std::move(other) }
+        , root { std::exchange(other.root, nullptr) }
+        , count { std::exchange(other.count, 0) } {}
+
+    HollowPQ &operator=(HollowPQ &&rhs) noexcept {
+        std::swap(this->compare, rhs.compare);
+        PQCounters::operator=(rhs);
+        std::swap(root, rhs.root);
+        std::swap(count, rhs.count);
+        return *this;
+    }  // operator=()
+
+
+    // Description: Destructor
+    // Runtime: O(n + number of hollow cells)
+    ~HollowPQ() { clear(); }
+
+
+    // Description: Assumes that all elements inside the heap are out of
+    //              order and rebuilds it. Every Node stays valid; only the
+    //              cells holding them are replaced, and hollow cells are
+    //              dropped.
+    // Runtime: O(n + number of hollow cells)
+    virtual void updatePriorities() {
+        this->countUpdate();
+        std::vector<Node *> items;
+        items.reserve(count);
+        for (Cell *cell : cells()) {
+            if (cell->item) {
+                items.push_back(cell->item);
+            }
+            delete cell;
+        }
+        root = nullptr;
+        for (Node *item : items) {
+            insert(newCell(item));
+        }
+    }  // updatePriorities()
+
+
+    // Description: Add a new element to the heap.
+    // Runtime: O(1)
+    virtual void push(const TYPE &val) { addNode(val); }
+
+
+    // Description: Remove the most extreme (defined by 'compare') element
+    //              from the heap.
+    // Runtime: Amortized O(log(n))
+    virtual void pop() {
+        if (!root) {
+            return;
+        }
+        delete root->item;
+        root->item = nullptr;
+        --count;
+        remove_root();
+    }  // pop()
+
+
+    // Description: Return the most extreme (defined by 'compare') element of
+    //              the heap.
+    // Runtime: O(1)
+    virtual const TYPE &top() const { return root->item->elt; }
+
+
+    // Description: Get the number of elements in the heap.
+    // Runtime: O(1)
+    [[nodiscard]] virtual std::size_t size() const { return count; }
+
+
+    // Description: Return true if the heap is empty.
+    // Runtime: O(1)
+    [[nodiscard]] virtual bool empty() const { return count == 0; }
+
+
+    // Description: Add a new element to the heap. Returns a Node* that stays
+    //              valid until the element is popped.
+    // Runtime: O(1)
+    Node *addNode(const TYPE &val) {
+        auto *node = new Node(val);
+        this->countAllocations();
+        this->countCopies();
+        insert(newCell(node));
+        ++count;
+        return node;
+    }  // addNode()
+
+
+    // Description: Updates the priority of an element already in the heap
+    //              by replacing the element referred to by node with
+    //              new_value.
+    //
+    // PRECONDITION: The new priority, given by 'new_value' must be more
+    //              extreme (as defined by comp) than the old priority.
+    //
+    // Runtime: Amortized O(1)
+    void updateElt(Node *node, const TYPE &new_value) {
+        node->elt = new_value;
+        this->countCopies();
+        Cell *old_cell = node->cell;
+        if (old_cell == root) {
+            return;
+        }
+
+        // The old cell stays where it is, hollow, and also becomes the last
+        // child of the new one, which takes over part of its rank.
+        Cell *cell = newCell(node);
+        old_cell->item = nullptr;
+        cell->rank = old_cell->rank > 2 ? old_cell->rank - 2 : 0;
+        cell->child = old_cell;
+        old_cell->second_parent = cell;
+        root = link(cell, root);
+    }  // updateElt()
+
+
+    // Description: Write the heap to os as a binary snapshot (see
+    //              Snapshot.hpp), as a flat list that starts with the most
+    //              extreme element. TYPE must be trivially copyable.
+    // Runtime: O(n + number of hollow cells)
+    void save(std::ostream &os) const {
+        std::vector<TYPE> elements;
+        elements.reserve(count);
+        forEachCell([&elements](Cell *cell) {
+            if (cell->item) {
+                elements.push_back(cell->item->elt);
+            }
+        });
+        writeSnapshotHeader<TYPE>(os, elements.size(), SnapshotLayout::TopFirst);
+        writeSnapshotElements(os, elements.data(), elements.size());
+    }  // save()
+
+
+    // Description: Replace the contents of the heap with a snapshot read
+    //              from is, of any layout. Nodes from before the load are no
+    //              longer valid.
+    // Runtime: O(n)
+    void load(std::istream &is) {
+        SnapshotHeader header = readSnapshotHeader<TYPE>(is);
+        std::vector<TYPE> elements(header.count);
+        readSnapshotElements(is, elements.data(), elements.size());
+        clear();
+        for (const TYPE &element : elements) {
+            addNode(element);
+        }
+    }  // load()
+
+
+private:
+    // A place in the heap. A full cell holds an element; a hollow one is
+    // what updateElt() or a deletion leaves behind. A hollow cell can have
+    // two parents: the one whose child list it was in, and the cell its
+    // element moved to, whose child list always ends with it.
+    struct Cell {
+        explicit Cell(Node *node)
+            : item { node } {}
+
+        Node *item;                      // nullptr if hollow
+        Cell *child = nullptr;           // First child
+        Cell *next = nullptr;            // Next sibling in the first parent's list
+        Cell *second_parent = nullptr;   // Set while a hollow cell has two parents
+        std::size_t rank = 0;
+    };  // Cell
+
+    Cell *root = nullptr;
+    std::size_t count = 0;
+
+    // Roots of each rank while pop() links them, kept between pops so that
+    // it is not reallocated every time.
+    std::vector<Cell *> ranks;
+
+    Cell *newCell(Node *node) {
+        auto *cell = new Cell(node);
+        this->countAllocations();
+        node->cell = cell;
+        return cell;
+    }
+
+    // Make the lower priority of two full cells a child of the other, and
+    // return the one that is left as a root.
+    Cell *link(Cell *a, Cell *b) {
+        if (this->counted(this->compare)(a->item->elt, b->item->elt)) {
+            std::swap(a, b);
+        }
+        b->next = a->child;
+        a->child = b;
+        return a;
+    }
+
+    void insert(Cell *cell) { root = root ? link(cell, root) : cell; }
+
+    // Destroy the hollow root, and every hollow cell that is left with no
+    // parent as a result, then link the full cells left over into one tree:
+    // first those of equal rank, then all of them.
+    void remove_root() {
+        std::size_t max_rank = 0;
+        Cell *hollow = root;
+        hollow->next = nullptr;
+        root = nullptr;
+
+        while (hollow) {
+            Cell *parent = hollow;
+            hollow = hollow->next;
+            Cell *next_child = parent->child;
+            while (next_child) {
+                Cell *cell = next_child;
+                next_child = next_child->next;
+                if (!cell->item) {
+                    if (!cell->second_parent) {
+                        cell->next = hollow;
+                        hollow = cell;
+                    } else {
+                        // The cell keeps its other parent. It ends the
+                        // second parent's list, and must end it from now
+                        // on if it was the first parent's.
+                        if (cell->second_parent == parent) {
+                            next_child = nullptr;
+                        } else {
+                            cell->next = nullptr;
+                        }
+                        cell->second_parent = nullptr;
+                    }
+                    continue;
+                }
+                while (cell->rank < ranks.size() && ranks[cell->rank]) {
+                    Cell *other = ranks[cell->rank];
+                    ranks[cell->rank] = nullptr;
+                    cell = link(cell, other);
+                    ++cell->rank;
+                }
+                if (cell->rank >= ranks.size()) {
+                    ranks.resize(cell->rank + 1, nullptr);
+                }
+                ranks[cell->rank] = cell;
+                max_rank = std::max(max_rank, cell->rank);
+            }
+            delete parent;
+        }
+
+        for (std::size_t rank = 0; rank <= max_rank && rank < ranks.size(); ++rank) {
+            if (ranks[rank]) {
+                insert(ranks[rank]);
+                ranks[rank] = nullptr;
+            }
+        }
+    }
+
+    // Visit every cell once, parents before children, without recursion.
+    // A cell with two parents is visited through its first parent only.
+    // Telling which parent that is reads the child, so the visitor must not
+    // delete cells; collect them with cells() instead.
+    template<typename Visitor>
+    void forEachCell(Visitor visitor) const {
+        std::vector<Cell *> stack;
+        if (root) {
+            stack.push_back(root);
+        }
+        while (!stack.empty()) {
+            Cell *cell = stack.back();
+            stack.pop_back();
+            for (Cell *child = cell->child; child && child->second_parent != cell; child = child->next) {
+                stack.push_back(child);
+            }
+            visitor(cell);
+        }
+    }
+
+    std::vector<Cell *> cells() const {
+        std::vector<Cell *> all;
+        forEachCell([&all](Cell *cell) { all.push_back(cell); });
+        return all;
+    }
+
+    // Delete every cell and node.
+    void clear() {
+        for (Cell *cell : cells()) {
+            delete cell->item;
+            delete cell;
+        }
+        root = nullptr;
+        count = 0;
+    }
+};  // HollowPQ
+
+#endif  // HOLLOWPQ_H
@@ -0,0 +1,202 @@
+// Project identifier: 43DE0E0C4C76BFAA6D8C2F5AEAE0518A9C42CF4E
+
+#ifndef HUGEPAGES_H
+#define HUGEPAGES_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <memory_resource>
+#include <new>
+#include <stdexcept>
+#include <string>
+
+#include <linux/mempolicy.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+// A memory_resource for very large array-based PQs, which maps their
+// storage straight from the kernel backed by huge pages and placed across
+// NUMA nodes as asked. It plugs into the Pmr aliases (see Allocator.hpp):
+//     HugePageResource pages { HugePageOptions { HugePages::Explicit, NumaPlacement::Interleave } };
+//     PmrBinaryPQ<Job> pq { std::less<Job> {}, &pages };
+//     pq.reserve(n);  // One mapping, rather than one per doubling
+//
+// Explicit huge pages come from the pool reserved in
+// /proc/sys/vm/nr_hugepages (MAP_HUGETLB); when it is empty or missing the
+// mapping falls back to transparent huge pages, which madvise() asks for
+// on a mapping aligned to the huge page size. Whether the kernel grants
+// them depends on /sys/kernel/mm/transparent_hugepage/enabled. A NUMA
+// placement the kernel refuses (no NUMA support, or a container that
+// forbids mbind()) is counted and the memory used as placed by default.
+// Allocations below min_bytes go to the upstream resource.
+
+// Which pages back a mapping.
+enum class HugePages {
+    None,         // Normal pages
+    Transparent,  // Transparent huge pages, through madvise(MADV_HUGEPAGE)
+    Explicit,     // Reserved huge pages (MAP_HUGETLB), else Transparent
+};
+
+// Where a mapping's pages go on a NUMA machine.
+enum class NumaPlacement {
+    Default,     // The kernel's policy, usually the node that first touches each page
+    Interleave,  // Round-robin over every online node
+    Bind,        // Only on HugePageOptions::node
+};
+
+struct HugePageOptions {
+    HugePages pages = HugePages::Transparent;
+    NumaPlacement numa = NumaPlacement::Default;
+    unsigned node = 0;                                 // The node for NumaPlacement::Bind
+    std::size_t min_bytes = std::size_t { 1 } << 21u;  // NOLINT: one 2 MiB huge page
+};
+
+
+class HugePageResource : public std::pmr::memory_resource {
+public:
+    // The huge page size assumed for rounding and alignment, the x86-64
+    // and arm64 default.
+    static constexpr std::size_t kHugePageSize = std::size_t { 1 } << 21u;  // NOLINT: 2 MiB
+
+    // Description: Construct a resource that maps allocations as options
+    //              asks. Throws std::invalid_argument if options binds to a
+    //              node that is not online, or one past the 64 supported.
+    // Runtime: O(1)
+    explicit HugePageResource(HugePageOptions options = HugePageOptions(),
+                              std::pmr::memory_resource *upstream = std::pmr::get_default_resource())
+        : opts { options }
+        , upstream { upstream } {
+        nodes = onlineNodes();
+        if (opts.numa == NumaPlacement::Bind) {
+            if (opts.node >= kMaxNodes || (nodes & (std::uint64_t { 1 } << opts.node)) == 0) {
+                throw std::invalid_argument("HugePageResource: NUMA node " + std::to_string(opts.node)
+                                            + " is not online");
+            }
+            nodes = std::uint64_t { 1 } << opts.node;
+        }
+    }  // HugePageResource()
+
+
+    // Memory from a resource goes back to it, so it cannot be copied.
+    HugePageResource(const HugePageResource &) = delete;
+    HugePageResource &operator=(const HugePageResource &) = delete;
+
+
+    // Description: Return the options the resource was constructed with.
+    [[nodiscard]] const HugePageOptions &options() const { return opts; }
+
+
+    // Description: Return the number of allocations mapped by this resource
+    //              rather than passed upstream.
+    [[nodiscard]] std::size_t mappings() const { return mapped.load(std::memory_order_relaxed); }
+
+
+    // Description: Return the number of HugePages::Explicit mappings that
+    //              fell back to transparent huge pages.
+    [[nodiscard]] std::size_t fallbacks() const { return fell_back.load(std::memory_order_relaxed); }
+
+
+    // Description: Return the number of mappings whose NUMA placement the
+    //              kernel refused.
+    [[nodiscard]] std::size_t placementFailures() const { return misplaced.load(std::memory_order_relaxed); }
+
+
+private:
+    static constexpr unsigned kMaxNodes = 64;  // NOLINT: one word of node mask
+
+    HugePageOptions opts;
+    std::pmr::memory_resource *upstream;
+    std::uint64_t nodes = 1;  // Node mask for the NUMA placement
+    std::atomic<std::size_t> mapped { 0 };
+    std::atomic<std::size_t> fell_back { 0 };
+    std::atomic<std::size_t> misplaced { 0 };
+
+    void *do_allocate(std::size_t bytes, std::size_t alignment) override {
+        if (bytes < opts.min_bytes || alignment > kHugePageSize) {
+            return upstream->allocate(bytes, alignment);
+        }
+        std::size_t length = roundUp(bytes);
+        void *addr = MAP_FAILED;
+        if (opts.pages == HugePages::Explicit) {
+            addr = ::mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+            if (addr == MAP_FAILED) {
+                fell_back.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+        if (addr == MAP_FAILED) {
+            addr = mapAligned(length);
+            if (opts.pages != HugePages::None) {
+                ::madvise(addr, length, MADV_HUGEPAGE);
+            }
+        }
+        // The pages are not touched yet, so the policy decides where every
+        // one of them goes.
+        if (opts.numa != NumaPlacement::Default) {
+            int mode = opts.numa == NumaPlacement::Interleave ? MPOL_INTERLEAVE : MPOL_BIND;
+            if (::syscall(SYS_mbind, addr, length, mode, &nodes, kMaxNodes + 1, 0) != 0) {
+                misplaced.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+        mapped.fetch_add(1, std::memory_order_relaxed);
+        return addr;
+    }
+
+    void do_deallocate(void *addr, std::size_t bytes, std::size_t alignment) override {
+        if (bytes < opts.min_bytes || alignment > kHugePageSize) {
+            upstream->deallocate(addr, bytes, alignment);
+            return;
+        }
+        ::munmap(addr, roundUp(bytes));
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override { return this == &other; }
+
+    static std::size_t roundUp(std::size_t bytes) { return (bytes + kHugePageSize - 1) & ~(kHugePageSize - 1); }
+
+    // Map length bytes aligned to the huge page size, the only regions
+    // transparent huge pages can back, by over-mapping and trimming.
+    static void *mapAligned(std::size_t length) {
+        std::size_t padded = length + kHugePageSize;
+        void *raw = ::mmap(nullptr, padded, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (raw == MAP_FAILED) {
+            throw std::bad_alloc();
+        }
+        auto start = reinterpret_cast<std::uintptr_t>(raw);
+        auto aligned = (start + kHugePageSize - 1) & ~(std::uintptr_t { kHugePageSize } - 1);
+        if (aligned > start) {
+            ::munmap(raw, aligned - start);
+        }
+        std::size_t tail = padded - (aligned - start) - length;
+        if (tail > 0) {
+            ::munmap(reinterpret_cast<void *>(aligned + length), tail);
+        }
+        return reinterpret_cast<void *>(aligned);
+    }
+
+    // The online NUMA nodes as a mask, read from a list like "0-1,3". A
+    // kernel without NUMA has only node 0.
+    static std::uint64_t onlineNodes() {
+        std::ifstream online { "/sys/devices/system/node/online" };
+        std::uint64_t mask = 0;
+        unsigned first = 0;
+        while (online >> first) {
+            unsigned last = first;
+            if (online.peek() == '-') {
+                online.ignore();
+                online >> last;
+            }
+            for (unsigned node = first; node <= last && node < kMaxNodes; ++node) {
+                mask |= std::uint64_t { 1 } << node;
+            }
+            if (online.peek() == ',') {
+                online.ignore();
+            }
+        }
+        return mask != 0 ? mask : 1;
+    }
+};  // HugePageResource
+
+#endif  // HUGEPAGES_H
@@ -0,0 +1,224 @@
+// Project identifier: 43DE0E0C4C76BFAA6D8C2F5AEAE0518A9C42CF4E
+
+#ifndef KWAYMERGE_H
+#define KWAYMERGE_H
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+#include "BinaryPQ.hpp"
+
+// Merging k sorted runs into one, as std::merge does for two: every run
+// must be sorted by COMP_FUNCTOR, the output is sorted by it as well, and
+// equal elements come out in run order, so the merge is stable.
+//
+// HeapMerge keeps the head of each run in a BinaryPQ and advances the run
+// on top with replaceTop(), about 2 log(k) comparisons per element.
+// LoserTreeMerge plays a tournament between the runs and replays only the
+// winner's path, about log(k) comparisons per element. Both can be
+// used as a stream (empty(), top(), pop()) or through kWayMerge().
+
+// A sorted run, as a pair of iterators.
+template<typename InputIterator>
+using MergeRun = std::pair<InputIterator, InputIterator>;
+
+template<typename InputIterator>
+using MergeValue = typename std::iterator_traits<InputIterator>::value_type;
+
+
+template<typename InputIterator, typename COMP_FUNCTOR = std::less<MergeValue<InputIterator>>>
+class HeapMerge {
+public:
+    using value_type = MergeValue<InputIterator>;
+
+    // Description: Start merging runs.
+    // Runtime: O(k)
+    explicit HeapMerge(std::vector<MergeRun<InputIterator>> runs, COMP_FUNCTOR comp = COMP_FUNCTOR())
+        : runs { std::move(runs) }
+        , heads { HeadComp { comp } } {
+        std::vector<Head> first;
+        for (std::size_t run = 0; run < this->runs.size(); ++run) {
+            if (this->runs[run].first != this->runs[run].second) {
+                first.push_back(Head { *this->runs[run].first, run });
+            }
+        }
+        heads = Heap { first.begin(), first.end(), HeadComp { comp } };
+    }  // HeapMerge()
+
+
+    // Description: Return true once every run has been consumed.
+    // Runtime: O(1)
+    [[nodiscard]] bool empty() const { return heads.empty(); }
+
+
+    // Description: Return the next element of the merged output.
+    // Runtime: O(1)
+    const value_type &top() const { return heads.top().elt; }
+
+
+    // Description: Move past the next element of the merged output.
+    // Runtime: O(log(k))
+    void pop() {
+        std::size_t run = heads.top().run;
+        if (++runs[run].first == runs[run].second) {
+            heads.pop();
+        } else {
+            heads.replaceTop(Head { *runs[run].first, run });
+        }
+    }  // pop()
+
+
+private:
+    struct Head {
+        value_type elt {};
+        std::size_t run = 0;
+    };
+
+    // The most extreme head comes first in the output: the least by COMP,
+    // then the one from the earliest run.
+    struct HeadComp {
+        COMP_FUNCTOR compare;
+        bool operator()(const Head &a, const Head &b) const {
+            if (compare(b.elt, a.elt)) {
+                return true;
+            }
+            return !compare(a.elt, b.elt) && b.run < a.run;
+        }
+    };
+
+    using Heap = BinaryPQ<Head, HeadComp>;
+
+    std::vector<MergeRun<InputIterator>> runs;
+    Heap heads;
+};  // HeapMerge
+
+
+template<typename InputIterator, typename COMP_FUNCTOR = std::less<MergeValue<InputIterator>>>
+class LoserTreeMerge {
+public:
+    using value_type = MergeValue<InputIterator>;
+
+    // Description: Start merging runs by playing the first tournament.
+    // Runtime: O(k)
+    explicit LoserTreeMerge(std::vector<MergeRun<InputIterator>> runs, COMP_FUNCTOR comp = COMP_FUNCTOR())
+        : runs { std::move(runs) }
+        , compare { comp }
+        , tree(std::max<std::size_t>(this->runs.size(), 1)) {
+        std::size_t k = this->runs.size();
+        if (k == 0) {
+            tree[0].done = true;
+            return;
+        }
+        // Leaf j of the tree is at k + j; the winner of each match moves up
+        // and the loser stays in the node.
+        std::vector<Entry> winners(2 * k);
+        for (std::size_t run = 0; run < k; ++run) {
+            winners[k + run].run = run;
+            load(winners[k + run]);
+        }
+        for (std::size_t node = k - 1; node >= 1; --node) {
+            bool left_wins = beats(winners[2 * node], winners[2 * node + 1]);
+            winners[node] = winners[2 * node + !left_wins];
+            tree[node] = winners[2 * node + left_wins];
+        }
+        tree[0] = winners[k == 1 ? k : 1];
+    }  // LoserTreeMerge()
+
+
+    // Description: Return true once every run has been consumed.
+    // Runtime: O(1)
+    [[nodiscard]] bool empty() const { return tree[0].done; }
+
+
+    // Description: Return the next element of the merged output.
+    // Runtime: O(1)
+    const value_type &top() const { return tree[0].elt; }
+
+
+    // Description: Move past the next element of the merged output, and
+    //              replay the winner's matches on the way up the tree.
+    // Runtime: O(log(k))
+    void pop() {
+        Entry winner = std::move(tree[0]);
+        ++runs[winner.run].first;
+        load(winner);
+        for (std::size_t node = (winner.run + runs.size()) / 2; node >= 1; node /= 2) {
+            if (beats(tree[node], winner)) {
+                std::swap(tree[node], winner);
+            }
+        }
+        tree[0] = std::move(winner);
+    }  // pop()
+
+
+private:
+    // A run's current head, copied into the tree so that replaying a match
+    // does not have to follow the run's iterator.
+    struct Entry {
+        value_type elt {};
+        std::size_t run = 0;
+        bool done = false;  // The run has been consumed
+    };
+
+    std::vector<MergeRun<InputIterator>> runs;
+    COMP_FUNCTOR compare;
+    std::vector<Entry> tree;  // tree[0] is the overall winner, the rest losers
+
+    void load(Entry &entry) const {
+        const auto &run = runs[entry.run];
+        entry.done = run.first == run.second;
+        if (!entry.done) {
+            entry.elt = *run.first;
+        }
+    }
+
+    // Whether a goes out before b. A consumed run loses to everything, and
+    // ties go to the earlier run.
+    bool beats(const Entry &a, const Entry &b) const {
+        if (a.done || b.done) {
+            return !a.done;
+        }
+        if (compare(a.elt, b.elt)) {
+            return true;
+        }
+        return !compare(b.elt, a.elt) && a.run < b.run;
+    }
+};  // LoserTreeMerge
+
+
+// Which k-way merge kWayMerge() uses.
+enum class MergeStrategy {
+    Heap,       // HeapMerge
+    LoserTree,  // LoserTreeMerge
+};
+
+
+// Description: Merge the sorted runs into out, and return the end of the
+//              output.
+// Runtime: O(n log(k)) where n is the total length of the runs.
+template<typename InputIterator, typename OutputIterator,
+         typename COMP_FUNCTOR = std::less<MergeValue<InputIterator>>>
+OutputIterator kWayMerge(std::vector<MergeRun<InputIterator>> runs, OutputIterator out,
+                         COMP_FUNCTOR comp = COMP_FUNCTOR(), MergeStrategy strategy = MergeStrategy::LoserTree) {
+    auto drain = [&out](auto &merge) {
+        while (!merge.empty()) {
+            *out = merge.top();
+            ++out;
+            merge.pop();
+        }
+    };
+    if (strategy == MergeStrategy::Heap) {
+        HeapMerge<InputIterator, COMP_FUNCTOR> merge { std::move(runs), comp };
+        drain(merge);
+    } else {
+        LoserTreeMerge<InputIterator, COMP_FUNCTOR> merge { std::move(runs), comp };
+        drain(merge);
+    }
+    return out;
+}  // kWayMerge()
+
+#endif  // KWAYMERGE_H
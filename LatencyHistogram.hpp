@@ -0,0 +1,99 @@
+// Project identifier: 43DE0E0C4C76BFAA6D8C2F5AEAE0518A9C42CF4E
+
+#ifndef LATENCYHISTOGRAM_H
+#define LATENCYHISTOGRAM_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// A log-linear (HDR-style) histogram of latencies in nanoseconds. Values
+// below 32 get a bucket each; above that, every power of two is split into
+// 32 buckets, so any recorded value is known to within about 3% over the
+// whole 64-bit range. Recording is O(1) and the histogram is a fixed 15 KiB,
+// whatever it records.
+class LatencyHistogram {
+public:
+    // Description: Add one latency, in nanoseconds.
+    // Runtime: O(1)
+    void record(std::uint64_t ns) {
+        ++counts[bucketOf(ns)];
+        ++total;
+        if (ns > largest) {
+            largest = ns;
+        }
+    }  // record()
+
+
+    // Description: Get the number of latencies recorded.
+    [[nodiscard]] std::uint64_t count() const { return total; }
+
+    // Description: Get the largest latency recorded, exactly.
+    [[nodiscard]] std::uint64_t max() const { return largest; }
+
+
+    // Description: Get the latency that 'fraction' (e.g. 0.999) of the
+    //              recorded latencies do not exceed, rounded up to the end
+    //              of its bucket. Returns 0 if nothing has been recorded.
+    // Runtime: O(number of buckets)
+    [[nodiscard]] std::uint64_t percentile(double fraction) const {
+        auto rank = static_cast<std::uint64_t>(fraction * static_cast<double>(total));
+        std::uint64_t seen = 0;
+        for (std::size_t bucket = 0; bucket < kBuckets; ++bucket) {
+            seen += counts[bucket];
+            if (seen > rank || (seen == total && seen > 0)) {
+                std::uint64_t high = bucketHigh(bucket);
+                return high < largest ? high : largest;
+            }
+        }
+        return 0;
+    }  // percentile()
+
+
+    // Description: Add every latency recorded in other to this histogram.
+    // Runtime: O(number of buckets)
+    void merge(const LatencyHistogram &other) {
+        for (std::size_t bucket = 0; bucket < kBuckets; ++bucket) {
+            counts[bucket] += other.counts[bucket];
+        }
+        total += other.total;
+        if (other.largest > largest) {
+            largest = other.largest;
+        }
+    }  // merge()
+
+
+    // Description: Forget every recorded latency.
+    void reset() { *this = LatencyHistogram {}; }
+
+
+private:
+    static constexpr unsigned kSubBits = 5;
+    static constexpr std::uint64_t kSubBuckets = std::uint64_t { 1 } << kSubBits;
+    static constexpr std::size_t kBuckets = (64 - kSubBits + 1) * kSubBuckets;
+
+    std::array<std::uint64_t, kBuckets> counts {};
+    std::uint64_t total = 0;
+    std::uint64_t largest = 0;
+
+    static std::size_t bucketOf(std::uint64_t ns) {
+        if (ns < kSubBuckets) {
+            return static_cast<std::size_t>(ns);
+        }
+        auto msb = static_cast<unsigned>(63 - __builtin_clzll(ns));  // NOLINT: bit index
+        unsigned shift = msb - kSubBits;
+        return static_cast<std::size_t>((shift + 1) * kSubBuckets + (ns >> shift) - kSubBuckets);
+    }  // bucketOf()
+
+    // The largest value that falls in bucket.
+    static std::uint64_t bucketHigh(std::size_t bucket) {
+        if (bucket < kSubBuckets) {
+            return bucket;
+        }
+        auto shift = static_cast<unsigned>(bucket / kSubBuckets - 1);
+        std::uint64_t sub = bucket % kSubBuckets + kSubBuckets;
+        return ((sub + 1) << shift) - 1;
+    }  // bucketHigh()
+};  // LatencyHistogram
+
+#endif  // LATENCYHISTOGRAM_H
@@ -0,0 +1,295 @@
+// Project identifier: 43DE0E0C4C76BFAA6D8C2F5AEAE0518A9C42CF4E
+
+#ifndef MAPPEDBINARYPQ_H
+#define MAPPEDBINARYPQ_H
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "Eecs281PQ.hpp"
+#include "HeapSift.hpp"
+
+// When a MappedBinaryPQ asks the kernel to write its pages back to disk.
+enum class SyncPolicy {
+    Never,    // Leave write-back entirely to the kernel.
+    OnClose,  // msync() once, when the PQ is destroyed.
+    EveryOp,  // Schedule write-back (MS_ASYNC) after every mutation.
+};
+
+// A binary heap whose storage is a memory-mapped file instead of a vector,
+// so a very large heap survives restarts without being rebuilt. The file
+// holds a small header followed by the heap array, laid out exactly like
+// BinaryPQ's data vector (slot 0 unused). Reopening a cleanly closed file
+// costs O(1). If the process died in the middle of an operation, the heap
+// invariant is restored with one O(n) rebuild the first time it is used,
+// but the rebuild cannot undo a half-finished write: an element that was
+// being pushed, popped or swapped at the time may be lost or duplicated.
+// TYPE must be trivially copyable, since it is stored as raw bytes.
+template<typename TYPE, typename COMP_FUNCTOR = std::less<TYPE>>
+class MappedBinaryPQ : public Eecs281PQ<TYPE, COMP_FUNCTOR> {
+    static_assert(std::is_trivially_copyable<TYPE>::value,
+                  "MappedBinaryPQ stores TYPE as raw bytes in a file");
+
+    // This is a way to refer to the base class object.
+    using BaseClass = Eecs281PQ<TYPE, COMP_FUNCTOR>;
+
+public:
+    // Description: Open the heap stored in the file at path, creating an
+    //              empty one if the file does not exist or is empty. Throws
+    //              std::runtime_error if the file holds anything else.
+    // Runtime: O(1), plus O(n) on first use if the file was not closed
+    //          cleanly.
+    explicit MappedBinaryPQ(const std::string &path, COMP_FUNCTOR comp = COMP_FUNCTOR(),
+                            SyncPolicy policy = SyncPolicy::OnClose)
+        : BaseClass { comp }
+        , policy { policy } {
+        fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);  // NOLINT: rw-r--r--
+        if (fd < 0) {
+            throw std::runtime_error("MappedBinaryPQ: cannot open " + path);
+        }
+
+        struct stat info {};
+        if (::fstat(fd, &info) != 0) {
+            ::close(fd);
+            throw std::runtime_error("MappedBinaryPQ: cannot stat " + path);
+        }
+
+        try {
+            open_heap(path, static_cast<std::size_t>(info.st_size));
+        } catch (...) {
+            unmap();
+            ::close(fd);
+            throw;
+        }
+    }  // MappedBinaryPQ()
+
+
+    // Description: Flush according to the sync policy and unmap the file.
+    //              The heap is marked clean so reopening skips the rebuild.
+    // Runtime: O(1), plus the cost of writing back dirty pages.
+    virtual ~MappedBinaryPQ() {
+        repair();
+        header->clean = 1;
+        if (policy != SyncPolicy::Never) {
+            ::msync(base, mapped_bytes, MS_SYNC);
+        }
+        unmap();
+        ::close(fd);
+    }  // ~MappedBinaryPQ()
+
+
+    // Description: The file has exactly one owner, so copying and moving
+    //              are not allowed.
+    MappedBinaryPQ(const MappedBinaryPQ &) = delete;
+    MappedBinaryPQ(MappedBinaryPQ &&) = delete;
+    MappedBinaryPQ &operator=(const MappedBinaryPQ &) = delete;
+    MappedBinaryPQ &operator=(MappedBinaryPQ &&) = delete;
+
+
+    // Description: Assumes that all elements inside the heap are out of order
+    //              and 'rebuilds' the heap by fixing the heap invariant.
+    // Runtime: O(n)
+    virtual void updatePriorities() {
+        begin_op();
+        heapify();
+        end_op();
+    }  // updatePriorities()
+
+
+    // Description: Add a new element to the PQ, growing the file if needed.
+    // Runtime: Amortized O(log(n))
+    virtual void push(const TYPE &val) {
+        repair();
+        if (header->count + 1 >= header->capacity) {
+            grow();
+        }
+        begin_op();
+        data[header->count + 1] = val;
+        ++header->count;
+        fix_up(header->count);
+        end_op();
+    }  // push()
+
+
+    // Description: Remove the most extreme (defined by 'compare') element
+    //              from the PQ.
+    // Runtime: O(log(n))
+    virtual void pop() {
+        repair();
+        begin_op();
+        data[1] = data[header->count--];
+        if (header->count > 1) {
+            fix_down(1);
+        }
+        end_op();
+    }  // pop()
+
+
+    // Description: Return the most extreme (defined by 'compare') element of
+    //              the PQ.
+    // Runtime: O(1)
+    virtual const TYPE &top() const {
+        repair();
+        return data[1];
+    }  // top()
+
+
+    // Description: Get the number of elements in the PQ.
+    // Runtime: O(1)
+    [[nodiscard]] virtual std::size_t size() const { return static_cast<std::size_t>(header->count); }
+
+
+    // Description: Return true if the PQ is empty.
+    // Runtime: O(1)
+    [[nodiscard]] virtual bool empty() const { return header->count == 0; }
+
+
+    // Description: Return true if the stored array satisfies the heap
+    //              invariant. Useful to audit a file after a crash.
+    // Runtime: O(n)
+    [[nodiscard]] bool isHeap() const {
+        for (std::size_t i = 2; i <= size(); ++i) {
+            if (this->compare(data[i / 2], data[i])) {
+                return false;
+            }
+        }
+        return true;
+    }  // isHeap()
+
+
+    // Description: Synchronously write every dirty page back to the file.
+    void sync() { ::msync(base, mapped_bytes, MS_SYNC); }
+
+
+private:
+    // Layout of the first kHeaderBytes of the file.
+    struct Header {
+        std::uint64_t magic = kMagic;
+        std::uint64_t elt_size = sizeof(TYPE);
+        std::uint64_t count = 0;
+        std::uint64_t capacity = 0;  // Slots in the array, including slot 0
+        std::uint64_t clean = 1;     // 0 while an operation is in progress
+    };
+
+    static constexpr std::uint64_t kMagic = 0x3138325042515031;  // NOLINT: "1PQBP281"
+    static constexpr std::size_t kHeaderBytes = 64;              // NOLINT: one cache line
+    static constexpr std::size_t kInitialCapacity = 1024;        // NOLINT: arbitrary start
+    static_assert(sizeof(Header) <= kHeaderBytes, "header must fit before the array");
+    static_assert(alignof(TYPE) <= kHeaderBytes, "array must stay aligned after the header");
+
+    int fd = -1;
+    SyncPolicy policy;
+    void *base = nullptr;
+    std::size_t mapped_bytes = 0;
+    Header *header = nullptr;
+    TYPE *data = nullptr;
+
+    // Set when the file was not closed cleanly; the heap is rebuilt the
+    // next time it is used. Rebuilding only reorders the array, so it is
+    // allowed from const member functions.
+    mutable bool needs_repair = false;
+
+    // Set up the heap in a file of file_bytes bytes that was just opened:
+    // an empty file gets a new, empty heap, and anything else must hold a
+    // heap of this TYPE whose array fits in the file. The file may be
+    // longer than the array if a grow() was interrupted.
+    void open_heap(const std::string &path, std::size_t file_bytes) {
+        if (file_bytes == 0) {
+            resize_file(kHeaderBytes + kInitialCapacity * sizeof(TYPE));
+            adopt(map_file(kHeaderBytes + kInitialCapacity * sizeof(TYPE)),
+                  kHeaderBytes + kInitialCapacity * sizeof(TYPE));
+            *header = Header {};
+            header->capacity = kInitialCapacity;
+            return;
+        }
+        if (file_bytes < kHeaderBytes) {
+            throw std::runtime_error("MappedBinaryPQ: " + path + " is too short to hold a heap");
+        }
+        adopt(map_file(file_bytes), file_bytes);
+        if (header->magic != kMagic || header->elt_size != sizeof(TYPE) || header->capacity == 0
+            || header->capacity > (file_bytes - kHeaderBytes) / sizeof(TYPE)
+            || header->count >= header->capacity) {
+            throw std::runtime_error("MappedBinaryPQ: " + path + " is not a heap of this type");
+        }
+        needs_repair = header->clean == 0;
+    }  // open_heap()
+
+    void resize_file(std::size_t bytes) {
+        if (::ftruncate(fd, static_cast<off_t>(bytes)) != 0) {
+            throw std::runtime_error("MappedBinaryPQ: cannot resize file");
+        }
+    }  // resize_file()
+
+    // Map the first bytes of the file, without touching the current mapping.
+    void *map_file(std::size_t bytes) {
+        void *mapping = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (mapping == MAP_FAILED) {  // NOLINT: MAP_FAILED is a C-style cast
+            throw std::runtime_error("MappedBinaryPQ: cannot map file");
+        }
+        return mapping;
+    }  // map_file()
+
+    // Make mapping, of the given size, the one the PQ reads and writes.
+    void adopt(void *mapping, std::size_t bytes) {
+        base = mapping;
+        mapped_bytes = bytes;
+        header = static_cast<Header *>(base);
+        data = reinterpret_cast<TYPE *>(static_cast<char *>(base) + kHeaderBytes);
+    }  // adopt()
+
+    void unmap() {
+        if (base) {
+            ::munmap(base, mapped_bytes);
+            base = nullptr;
+        }
+    }  // unmap()
+
+    // Double the capacity of the file and remap it. The old mapping stays
+    // in use until the new one exists, so a failure leaves the PQ intact;
+    // the file is only ever longer than the array, which open_heap()
+    // accepts.
+    void grow() {
+        auto capacity = static_cast<std::size_t>(header->capacity) * 2;
+        std::size_t bytes = kHeaderBytes + capacity * sizeof(TYPE);
+        resize_file(bytes);
+        void *mapping = map_file(bytes);
+        unmap();
+        adopt(mapping, bytes);
+        header->capacity = capacity;
+    }  // grow()
+
+    // Bracket every mutation, so a crash in between is detected on reopen.
+    void begin_op() { header->clean = 0; }
+    void end_op() {
+        header->clean = 1;
+        if (policy == SyncPolicy::EveryOp) {
+            ::msync(base, mapped_bytes, MS_ASYNC);
+        }
+    }  // end_op()
+
+    void repair() const {
+        if (needs_repair) {
+            const_cast<MappedBinaryPQ *>(this)->heapify();
+            header->clean = 1;
+            needs_repair = false;
+        }
+    }  // repair()
+
+    void heapify() { heapBuild(data, size(), this->compare); }
+
+    void fix_up(std::size_t index) { heapSiftUp(data, index, this->compare); }
+
+    // The shared sift-down prefetches the grandchildren, which matters even
+    // more when the next level may not be paged in yet.
+    void fix_down(std::size_t index) { heapSiftDown(data, size(), index, this->compare); }
+};  // MappedBinaryPQ
+
+#endif  // MAPPEDBINARYPQ_H
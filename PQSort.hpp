@@ -0,0 +1,113 @@
+// Project identifier: 43DE0E0C4C76BFAA6D8C2F5AEAE0518A9C42CF4E
+
+#ifndef PQSORT_H
+#define PQSORT_H
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "BinaryPQ.hpp"
+#include "KWayMerge.hpp"
+#include "Parallel.hpp"
+
+// Sorting through the PQs, in the order std::sort uses: ascending by
+// COMP_FUNCTOR. The range is split into one chunk per thread, each chunk is
+// heapified with BinaryPQ's O(n) range constructor and popped into a
+// buffer, and then the sorted chunks are merged back into the range with a
+// LoserTreeMerge per thread. The merge is split between the threads by
+// splitters sampled from the sorted chunks, so each thread writes its own
+// slice of the output. Like std::sort, the sort is not stable.
+
+// Description: Return the ParallelOptions pq_sort() uses by default: every
+//              hardware thread, for ranges of at least min_size elements.
+inline ParallelOptions pqSortDefaults() {
+    ParallelOptions options;
+    options.threads = std::max(1u, std::thread::hardware_concurrency());
+    return options;
+}
+
+
+// Description: Sort [first, last) by comp, on several threads if parallel
+//              allows it for a range this size.
+// Runtime: O(n log(n)) work, about O((n / p) log(n)) time on p threads.
+template<typename RandomIt,
+         typename COMP_FUNCTOR = std::less<typename std::iterator_traits<RandomIt>::value_type>>
+void pq_sort(RandomIt first, RandomIt last, COMP_FUNCTOR comp = COMP_FUNCTOR(),
+             ParallelOptions parallel = pqSortDefaults()) {
+    using TYPE = typename std::iterator_traits<RandomIt>::value_type;
+    using BufferIt = typename std::vector<TYPE>::iterator;
+
+    auto n = static_cast<std::size_t>(last - first);
+    if (n < 2) {
+        return;
+    }
+    std::size_t chunks = parallel.useThreads(n) ? std::min<std::size_t>(parallel.threads, n) : 1;
+    auto chunkBegin = [n, chunks](std::size_t chunk) { return n * chunk / chunks; };
+
+    // Heapsort each chunk into the buffer. The heap pops the greatest
+    // element by comp first, so each chunk is filled from its end.
+    std::vector<TYPE> buffer(n);
+    parallelFor(chunks, parallel.threads, [&](std::size_t chunk) {
+        auto begin = static_cast<std::ptrdiff_t>(chunkBegin(chunk));
+        auto end = static_cast<std::ptrdiff_t>(chunkBegin(chunk + 1));
+        BinaryPQ<TYPE, COMP_FUNCTOR> heap { std::make_move_iterator(first + begin),
+                                            std::make_move_iterator(first + end), comp };
+        for (auto out = buffer.begin() + end; out != buffer.begin() + begin;) {
+            *--out = heap.top();
+            heap.pop();
+        }
+    });
+    if (chunks == 1) {
+        std::move(buffer.begin(), buffer.end(), first);
+        return;
+    }
+
+    // Regular sampling: chunks - 1 evenly spaced elements from each sorted
+    // chunk, of which every chunks'th one splits the output. Every slice of
+    // the output then holds at most about 2n / chunks elements, unless
+    // many elements are equal to a splitter.
+    std::vector<TYPE> samples;
+    for (std::size_t chunk = 0; chunk < chunks; ++chunk) {
+        std::size_t length = chunkBegin(chunk + 1) - chunkBegin(chunk);
+        for (std::size_t i = 1; i < chunks; ++i) {
+            samples.push_back(buffer[chunkBegin(chunk) + length * i / chunks]);
+        }
+    }
+    std::sort(samples.begin(), samples.end(), comp);
+
+    // bounds[slice][chunk] is where the slice starts in that chunk.
+    std::vector<std::vector<BufferIt>> bounds(chunks + 1, std::vector<BufferIt>(chunks));
+    for (std::size_t chunk = 0; chunk < chunks; ++chunk) {
+        auto begin = buffer.begin() + static_cast<std::ptrdiff_t>(chunkBegin(chunk));
+        auto end = buffer.begin() + static_cast<std::ptrdiff_t>(chunkBegin(chunk + 1));
+        bounds[0][chunk] = begin;
+        bounds[chunks][chunk] = end;
+        for (std::size_t slice = 1; slice < chunks; ++slice) {
+            const TYPE &splitter = samples[slice * (chunks - 1)];
+            bounds[slice][chunk] = std::lower_bound(bounds[slice - 1][chunk], end, splitter, comp);
+        }
+    }
+    std::vector<std::ptrdiff_t> offsets(chunks + 1, 0);
+    for (std::size_t slice = 0; slice < chunks; ++slice) {
+        offsets[slice + 1] = offsets[slice];
+        for (std::size_t chunk = 0; chunk < chunks; ++chunk) {
+            offsets[slice + 1] += bounds[slice + 1][chunk] - bounds[slice][chunk];
+        }
+    }
+
+    parallelFor(chunks, parallel.threads, [&](std::size_t slice) {
+        std::vector<MergeRun<std::move_iterator<BufferIt>>> runs;
+        for (std::size_t chunk = 0; chunk < chunks; ++chunk) {
+            runs.emplace_back(std::make_move_iterator(bounds[slice][chunk]),
+                              std::make_move_iterator(bounds[slice + 1][chunk]));
+        }
+        kWayMerge(std::move(runs), first + offsets[slice], comp);
+    });
+}  // pq_sort()
+
+#endif  // PQSORT_H
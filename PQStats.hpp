@@ -0,0 +1,115 @@
+// Project identifier: 43DE0E0C4C76BFAA6D8C2F5AEAE0518A9C42CF4E
+
+#ifndef PQSTATS_H
+#define PQSTATS_H
+
+#include <cstdint>
+
+#ifdef PQ_STATS
+#include <atomic>
+#endif
+
+// Operation counts reported by a PQ's stats(). Counting is only compiled in
+// with -DPQ_STATS; otherwise every count stays zero and the counting hooks
+// compile to nothing. Copies and moves are the ones the PQ makes itself:
+// elements shifted by vector::insert are counted, but those made inside
+// std::sort are not.
+struct PQStats {
+    std::uint64_t compares = 0;     // Calls to the comparator
+    std::uint64_t copies = 0;       // Elements copied into or within the PQ
+    std::uint64_t moves = 0;        // Elements moved within the PQ
+    std::uint64_t allocations = 0;  // Nodes allocated (PairingPQ, HollowPQ)
+    std::uint64_t sifts = 0;        // Calls to fix_up()/fix_down() (BinaryPQ)
+    std::uint64_t sift_levels = 0;  // Levels moved through by those sifts
+    std::uint64_t updates = 0;      // Calls to updatePriorities()
+};
+
+
+// Base class that gives each PQ its stats() accessor, plus the hooks its
+// implementation calls to count. Without PQ_STATS it has no members, so
+// the empty base optimization keeps it from adding to the size of a PQ.
+// With PQ_STATS the counters are relaxed atomics, because the parallel
+// rebuilds count from several threads.
+class PQCounters {
+#ifdef PQ_STATS
+public:
+    PQCounters() = default;
+    PQCounters(const PQCounters &other) { *this = other; }
+
+    PQCounters &operator=(const PQCounters &other) {
+        PQStats values = other.stats();
+        compares = values.compares;
+        copies = values.copies;
+        moves = values.moves;
+        allocations = values.allocations;
+        sifts = values.sifts;
+        sift_levels = values.sift_levels;
+        updates = values.updates;
+        return *this;
+    }  // operator=()
+
+    // Description: Get the counts accumulated since construction or the
+    //              last resetStats().
+    [[nodiscard]] PQStats stats() const {
+        PQStats values;
+        values.compares = compares.load(std::memory_order_relaxed);
+        values.copies = copies.load(std::memory_order_relaxed);
+        values.moves = moves.load(std::memory_order_relaxed);
+        values.allocations = allocations.load(std::memory_order_relaxed);
+        values.sifts = sifts.load(std::memory_order_relaxed);
+        values.sift_levels = sift_levels.load(std::memory_order_relaxed);
+        values.updates = updates.load(std::memory_order_relaxed);
+        return values;
+    }  // stats()
+
+    void resetStats() { *this = PQCounters {}; }
+
+protected:
+    // Description: Wrap comp so that every call through the result is
+    //              counted. Without PQ_STATS this returns comp itself.
+    template<typename COMP>
+    auto counted(const COMP &comp) const {
+        return [this, &comp](const auto &a, const auto &b) {
+            compares.fetch_add(1, std::memory_order_relaxed);
+            return comp(a, b);
+        };
+    }  // counted()
+
+    void countCompares(std::uint64_t n) const { compares.fetch_add(n, std::memory_order_relaxed); }
+    void countCopies(std::uint64_t n = 1) const { copies.fetch_add(n, std::memory_order_relaxed); }
+    void countMoves(std::uint64_t n = 1) const { moves.fetch_add(n, std::memory_order_relaxed); }
+    void countAllocations(std::uint64_t n = 1) const { allocations.fetch_add(n, std::memory_order_relaxed); }
+    void countUpdate() const { updates.fetch_add(1, std::memory_order_relaxed); }
+
+    void countSift(std::uint64_t levels) const {
+        sifts.fetch_add(1, std::memory_order_relaxed);
+        sift_levels.fetch_add(levels, std::memory_order_relaxed);
+    }  // countSift()
+
+private:
+    mutable std::atomic<std::uint64_t> compares { 0 };
+    mutable std::atomic<std::uint64_t> copies { 0 };
+    mutable std::atomic<std::uint64_t> moves { 0 };
+    mutable std::atomic<std::uint64_t> allocations { 0 };
+    mutable std::atomic<std::uint64_t> sifts { 0 };
+    mutable std::atomic<std::uint64_t> sift_levels { 0 };
+    mutable std::atomic<std::uint64_t> updates { 0 };
+#else
+public:
+    [[nodiscard]] PQStats stats() const { return PQStats {}; }
+    void resetStats() {}
+
+protected:
+    template<typename COMP>
+    const COMP &counted(const COMP &comp) const { return comp; }
+
+    void countCompares(std::uint64_t) const {}
+    void countCopies(std::uint64_t = 1) const {}
+    void countMoves(std::uint64_t = 1) const {}
+    void countAllocations(std::uint64_t = 1) const {}
+    void countUpdate() const {}
+    void countSift(std::uint64_t) const {}
+#endif
+};  // PQCounters
+
+#endif  // PQSTATS_H
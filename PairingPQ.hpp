@@ -3,15 +3,20 @@
 #ifndef PAIRINGPQ_H
 #define PAIRINGPQ_H
 
+#include <algorithm>
 #include <deque>
 #include <utility>
+#include <vector>
 
 #include "Eecs281PQ.hpp"
+#include "PQStats.hpp"
+#include "Snapshot.hpp"
+#include "Stable.hpp"
 
 // A specialized version of the priority queue ADT implemented as a pairing
 // heap.
 template<typename TYPE, typename COMP_FUNCTOR = std::less<TYPE>>
-class PairingPQ : public Eecs281PQ<TYPE, COMP_FUNCTOR> {
+class PairingPQ : public Eecs281PQ<TYPE, COMP_FUNCTOR>, public PQCounters {
     // This is a way to refer to the base class object.
     using BaseClass = Eecs281PQ<TYPE, COMP_FUNCTOR>;
 
@@ -39,6 +44,7 @@ public:
 
     private:
         TYPE elt;
+        InsertionOrder::Sequence sequence = 0;  // Used in stable mode only
         Node *child = nullptr;
         Node *sibling = nullptr;
         Node *parent = nullptr;
@@ -74,9 +80,11 @@ public:
     // Description: Copy constructor.
     // Runtime: O(n)
     PairingPQ(const PairingPQ &other)
-        : BaseClass { other.compare } {
+        : BaseClass { other.compare }
+        , PQCounters { other }
+        , order { other.order } {
         
-        pq_size = 0;
+        pq_size = other.pq_size;
         root_ptr = nullptr;
         this->compare = other.compare;
       if (other.root_ptr) {
@@ -96,6 +104,8 @@ public:
       if (this != &rhs) {
         clear(root_ptr);  // Clear the current heap
         this->compare = rhs.compare;
+        PQCounters::operator=(rhs);
+        order = rhs.order;
         pq_size = rhs.pq_size;
 
         if (rhs.root_ptr) {
@@ -118,10 +128,24 @@ public:
     }  // ~PairingPQ()
 
 
-    // Description: Move constructor and assignment operators don't need any
-    //              code, the members will be reused automatically.
-    PairingPQ(PairingPQ &&) noexcept = default;
-    PairingPQ &operator=(PairingPQ &&) noexcept = default;
+    // Description: Move constructor and assignment operators reuse the nodes.
+    //              The moved-from heap must give up its nodes, or both heaps
+    //              would delete them.
+    PairingPQ(PairingPQ &&other) noexcept
+        : BaseClass { std::move(other) }
+        , PQCounters { std::move(other) }
+        , root_ptr { std::exchange(other.root_ptr, nullptr) }
+        , pq_size { std::exchange(other.pq_size, 0) }
+        , order { other.order } {}
+
+    PairingPQ &operator=(PairingPQ &&rhs) noexcept {
+        std::swap(this->compare, rhs.compare);
+        PQCounters::operator=(rhs);
+        std::swap(root_ptr, rhs.root_ptr);
+        std::swap(pq_size, rhs.pq_size);
+        std::swap(order, rhs.order);
+        return *this;
+    }  // operator=()
 
 
     // Description: Assumes that all elements inside the pairing heap are out
@@ -130,27 +154,37 @@ public:
     //              and create new ones!
     // Runtime: O(n)
     virtual void updatePriorities() {
+        this->countUpdate();
         if(!root_ptr){
             return;
         }
-        
-        deque<Node*> melder;
+
+        // Detach every node into a singleton heap, then meld them back
+        // together pairwise, front to back, until one heap is left.
+        std::deque<Node*> melder;
         melder.push_back(root_ptr);
-        Node *node_ptr;
-        while(!melder.empty()){
-            node_ptr = melder.front();
+        for (size_t i = 0; i < melder.size(); ++i) {
+            Node *node_ptr = melder[i];
+            if (node_ptr->child) {
+                melder.push_back(node_ptr->child);
+            }
+            if (node_ptr->sibling) {
+                melder.push_back(node_ptr->sibling);
+            }
+        }
+        for (Node *node_ptr : melder) {
+            node_ptr->child = nullptr;
+            node_ptr->sibling = nullptr;
+            node_ptr->parent = nullptr;
+        }
+        while (melder.size() > 1) {
+            Node *first = melder.front();
             melder.pop_front();
-           if(node_ptr->child){
-            melder.push_back(node_ptr->child); 
-           } 
-           if(node_ptr->sibling){
-            melder.push_back(node_ptr->sibling);
-           }
-
-            meld(node_ptr, melder.front());
+            Node *second = melder.front();
             melder.pop_front();
- 
+            melder.push_back(meld(first, second));
         }
+        root_ptr = melder.front();
 
         // TODO: Implement this function.
     }  // updatePriorities()
@@ -175,7 +209,8 @@ public:
     if (!root_ptr) {
         return;  // Handle the case when the heap is empty
     }
-    deque<Node*> melder;
+    Node* old_root = root_ptr;
+    std::deque<Node*> melder;
     Node* current = root_ptr->child;
     
     // Push all children of the root to the deque
@@ -197,6 +232,7 @@ public:
     }
     
     root_ptr = melder.empty() ? nullptr : melder.front();  // Set the new root
+    delete old_root;
     --pq_size;  // Decrease the size of the heap
         // TODO: Implement this function.
     }  // pop()
@@ -239,29 +275,105 @@ public:
     //
     // Runtime: As discussed in reading material.
     void updateElt(Node *node, const TYPE &new_value) {
-        if (this->compare(new_value, node->elt)) {
         node->elt = new_value;
+        this->countCopies();
+        if (node == root_ptr) {
+            return;
+        }
 
         // Detach the node from its parent's child list
-        if (node->parent) {
-            if (node->parent->child == node) {
-                node->parent->child = node->sibling;
-            } else {
-                Node* sibling = node->parent->child;
-                while (sibling->sibling != node) {
-                    sibling = sibling->sibling;
-                }
-                sibling->sibling = node->sibling;
+        if (node->parent->child == node) {
+            node->parent->child = node->sibling;
+        } else {
+            Node* sibling = node->parent->child;
+            while (sibling->sibling != node) {
+                sibling = sibling->sibling;
             }
+            sibling->sibling = node->sibling;
         }
 
-        node->sibling = nullptr;  
-        node->parent = nullptr;   
-        meld(root_ptr, node);     
-    }
+        node->sibling = nullptr;
+        node->parent = nullptr;
+        root_ptr = meld(root_ptr, node);
     }  // updateElt()
 
 
+    // Description: Turn stable mode on or off. In stable mode, elements that
+    //              compare equal are popped in the order they were pushed,
+    //              at the cost of a 32-bit insertion number per node (often
+    //              free, in the padding after elt). An element keeps its
+    //              place among equals through updateElt(). Elements already
+    //              in the heap count as pushed parents first. The live
+    //              numbers are renumbered once limit elements have been
+    //              numbered; only tests need anything but the default.
+    // Runtime: O(n) to turn it on, O(1) otherwise
+    void setStable(bool stable, InsertionOrder::Sequence limit = InsertionOrder::kMaxLimit) {
+        order.setLimit(limit);
+        if (stable == order.enabled()) {
+            return;
+        }
+        order.enable(stable);
+        if (stable) {
+            forEachNode(root_ptr, [this](Node *node) { node->sequence = order.stamp(); });
+        }
+    }  // setStable()
+
+
+    // Description: Write the heap to os as a binary snapshot (see
+    //              Snapshot.hpp), as a flat list that starts with the root.
+    //              TYPE must be trivially copyable.
+    // Runtime: O(n)
+    void save(std::ostream &os) const {
+        writeSnapshotHeader<TYPE>(os, pq_size, SnapshotLayout::TopFirst);
+        std::vector<TYPE> block;
+        block.reserve(kSnapshotBlock);
+        forEachNode(root_ptr, [&](Node *node) {
+            block.push_back(node->elt);
+            if (block.size() == kSnapshotBlock) {
+                writeSnapshotElements(os, block.data(), block.size());
+                block.clear();
+            }
+        });
+        writeSnapshotElements(os, block.data(), block.size());
+    }  // save()
+
+
+    // Description: Replace the contents of the heap with a snapshot read from
+    //              is. When the snapshot starts with its most extreme element
+    //              (as saved by PairingPQ or BinaryPQ), that element becomes
+    //              the root and every other one its child, which is a valid
+    //              pairing heap. Any other layout is rebuilt. In stable
+    //              mode, the loaded elements count as pushed in their
+    //              stored order.
+    // Runtime: O(n)
+    void load(std::istream &is) {
+        SnapshotHeader header = readSnapshotHeader<TYPE>(is);
+        std::vector<TYPE> elements(header.count);
+        readSnapshotElements(is, elements.data(), elements.size());
+        clear(root_ptr);
+        root_ptr = nullptr;
+        pq_size = 0;
+        order.enable(order.enabled());  // Number from zero again
+
+        for (const TYPE &element : elements) {
+            Node *node = newNode(element);
+            stamp(node);
+            if (root_ptr) {
+                node->sibling = root_ptr->child;
+                node->parent = root_ptr;
+                root_ptr->child = node;
+            } else {
+                root_ptr = node;
+            }
+        }
+        pq_size = elements.size();
+
+        if (header.layout != SnapshotLayout::TopFirst && header.layout != SnapshotLayout::Heap) {
+            PairingPQ::updatePriorities();
+        }
+    }  // load()
+
+
     // Description: Add a new element to the pairing heap. Returns a Node*
     //              corresponding to the newly added element.
     // Runtime: O(1)
@@ -270,7 +382,8 @@ public:
     //       until it is eliminated by the user calling pop(). Remember this
     //       when you implement updateElt() and updatePriorities().
     Node *addNode(const TYPE &val) {
-	    Node* temp = new Node(val);
+	    Node* temp = newNode(val);
+        stamp(temp);
         if (root_ptr) {
 		root_ptr = meld(temp, root_ptr);
         } else {
@@ -290,7 +403,7 @@ private:
     // papers).
     Node *root_ptr = nullptr;
     Node* meld(Node* left_rootptr, Node* right_rootptr){
-        if(this->compare(left_rootptr->elt, right_rootptr->elt)){
+        if(lower(left_rootptr, right_rootptr)){
             left_rootptr->sibling = right_rootptr->child;
             right_rootptr->child = left_rootptr;
             left_rootptr->parent = right_rootptr;
@@ -303,37 +416,79 @@ private:
         }
     }
     size_t pq_size;
+    InsertionOrder order;
+
+    // Whether node a has lower priority than node b. In stable mode, ties
+    // go to the element pushed first.
+    bool lower(const Node *a, const Node *b) const {
+        const auto &less = this->counted(this->compare);
+        if (!order.enabled()) {
+            return less(a->elt, b->elt);
+        }
+        if (less(a->elt, b->elt)) {
+            return true;
+        }
+        return !less(b->elt, a->elt) && InsertionOrder::later(a->sequence, b->sequence);
+    }
 
-        void clear(Node *node) {
-        if (!node) {
-            return;  // Base case: nothing to clear
+    // Number a node about to join the heap, in stable mode.
+    void stamp(Node *node) {
+        if (!order.enabled()) {
+            return;
+        }
+        if (order.exhausted()) {
+            std::vector<InsertionOrder::Sequence *> live;
+            forEachNode(root_ptr, [&live](Node *current) { live.push_back(&current->sequence); });
+            order.renumber(live);
         }
+        node->sequence = order.stamp();
+    }
 
-        // Recursively clear the child and sibling nodes
-        clear(node->child);
-        clear(node->sibling);
+    // Elements are staged through blocks of this many when saving/loading.
+    static constexpr size_t kSnapshotBlock = 4096;  // NOLINT: arbitrary block
+
+    // Visit every node reachable from node (its children and its siblings)
+    // without recursion, since a pairing heap can be as deep as it is big.
+    // The visitor may delete the node it is given.
+    template<typename Visitor>
+    static void forEachNode(Node *node, Visitor visitor) {
+        std::vector<Node *> stack;
+        if (node) {
+            stack.push_back(node);
+        }
+        while (!stack.empty()) {
+            Node *current = stack.back();
+            stack.pop_back();
+            if (current->child) {
+                stack.push_back(current->child);
+            }
+            if (current->sibling) {
+                stack.push_back(current->sibling);
+            }
+            visitor(current);
+        }
+    }
 
-        // Once children and siblings are cleared, delete the current node
-        delete node;
+    Node *newNode(const TYPE &val) {
+        this->countAllocations();
+        this->countCopies();
+        return new Node(val);
     }
 
+    void clear(Node *node) {
+        forEachNode(node, [](Node *current) { delete current; });
+    }
+
+    // Copy every element under other_node into a fresh heap, returning its
+    // root. The shape differs from the original, which is allowed.
     Node* copyNode(Node* other_node) {
-    if (!other_node){
-       return nullptr; 
-    } 
-    
-    Node* new_node = new Node(other_node->elt);  // Copy the element
-    new_node->child = copyNode(other_node->child);  // Recursively copy child
-    new_node->sibling = copyNode(other_node->sibling);  // Recursively copy sibling
-    
-    if (new_node->child) {
-        new_node->child->parent = new_node;
-        }  // Set the child's parent
-    if (new_node->sibling){
-        new_node->sibling->parent = new_node->parent;
-    }   // Set the sibling's parent
-    
-    return new_node;
+        Node *new_root = nullptr;
+        forEachNode(other_node, [&](Node *current) {
+            Node *new_node = newNode(current->elt);
+            new_node->sequence = current->sequence;
+            new_root = new_root ? meld(new_root, new_node) : new_node;
+        });
+        return new_root;
     }
 
     // NOTE: For member variables, you are only allowed to add a "root
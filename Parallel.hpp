@@ -0,0 +1,160 @@
+// Project identifier: 43DE0E0C4C76BFAA6D8C2F5AEAE0518A9C42CF4E
+
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// How many threads a PQ may use for its O(n) and O(n log n) rebuilds, and
+// the size below which it stays on the calling thread because starting
+// threads would cost more than it saves.
+struct ParallelOptions {
+    unsigned threads = 1;
+    std::size_t min_size = std::size_t { 1 } << 16u;  // NOLINT: ~64K elements
+
+    // Description: Return true if a rebuild of n elements should use threads.
+    [[nodiscard]] bool useThreads(std::size_t n) const { return threads > 1 && n >= min_size; }
+};
+
+
+// Description: Call func(i) for every i in [0, tasks), splitting the range
+//              into contiguous blocks over up to 'threads' threads, one of
+//              which is the calling thread. Returns once every call is done.
+//              Calls running at the same time must not touch the same data.
+template<typename Func>
+void parallelFor(std::size_t tasks, unsigned threads, Func func) {
+    std::size_t workers = std::min<std::size_t>(threads, tasks);
+    auto runBlock = [&](std::size_t worker) {
+        for (std::size_t i = tasks * worker / workers; i < tasks * (worker + 1) / workers; ++i) {
+            func(i);
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (std::size_t worker = 1; worker < workers; ++worker) {
+        pool.emplace_back(runBlock, worker);
+    }
+    if (workers > 0) {
+        runBlock(0);
+    }
+    for (auto &thread : pool) {
+        thread.join();
+    }
+}  // parallelFor()
+
+
+// Threads kept waiting between calls, for callers that split small pieces
+// of work over threads many times, where starting threads in every
+// parallelFor() would cost more than the work. run() has the same contract
+// as parallelFor(). The threads start on the first run() that needs them.
+// A copy or a moved-to pool starts its own threads when it needs them, so
+// a class holding one can keep its default copy and move operations.
+class WorkerPool {
+public:
+    WorkerPool() = default;
+    ~WorkerPool() { stop(); }
+
+    WorkerPool(const WorkerPool &) {}
+    WorkerPool(WorkerPool &&) noexcept {}
+    WorkerPool &operator=(const WorkerPool &) { return *this; }
+    WorkerPool &operator=(WorkerPool &&) noexcept { return *this; }
+
+
+    // Description: Call func(i) for every i in [0, tasks), splitting the
+    //              range into contiguous blocks over up to 'threads'
+    //              threads, one of which is the calling thread. Returns
+    //              once every call is done. Calls running at the same time
+    //              must not touch the same data. Only one thread may call
+    //              run() on a pool at a time.
+    template<typename Func>
+    void run(std::size_t tasks, unsigned threads, Func func) {
+        std::size_t workers = std::min<std::size_t>(threads, tasks);
+        auto runBlock = [&](std::size_t worker) {
+            for (std::size_t i = tasks * worker / workers; i < tasks * (worker + 1) / workers; ++i) {
+                func(i);
+            }
+        };
+        if (workers <= 1) {
+            if (workers == 1) {
+                runBlock(0);
+            }
+            return;
+        }
+        if (pool.size() != threads - 1) {
+            stop();
+            start(threads - 1);
+        }
+
+        {
+            std::lock_guard<std::mutex> guard { mutex };
+            job = [](void *block, std::size_t worker) { (*static_cast<decltype(runBlock) *>(block))(worker); };
+            job_block = &runBlock;
+            active = workers;
+            pending = pool.size();
+            ++generation;
+        }
+        wake.notify_all();
+        runBlock(0);
+        std::unique_lock<std::mutex> lock { mutex };
+        done.wait(lock, [this] { return pending == 0; });
+    }  // run()
+
+private:
+    std::vector<std::thread> pool;
+    std::mutex mutex;
+    std::condition_variable wake;  // A new job, or stopping
+    std::condition_variable done;  // The last worker finished the job
+    void (*job)(void *, std::size_t) = nullptr;
+    void *job_block = nullptr;
+    std::size_t active = 0;      // Blocks in the job, the caller's included
+    std::size_t pending = 0;     // Workers yet to finish the job
+    std::size_t generation = 0;  // Counts jobs, so workers see each once
+    bool stopping = false;
+
+    void start(std::size_t workers) {
+        stopping = false;
+        for (std::size_t worker = 1; worker <= workers; ++worker) {
+            pool.emplace_back([this, worker, seen = generation] { work(worker, seen); });
+        }
+    }  // start()
+
+    void stop() {
+        {
+            std::lock_guard<std::mutex> guard { mutex };
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto &thread : pool) {
+            thread.join();
+        }
+        pool.clear();
+    }  // stop()
+
+    // Run block 'worker' of every job after the seen'th until the pool
+    // stops. Workers past the job's blocks only report that they are done.
+    void work(std::size_t worker, std::size_t seen) {
+        std::unique_lock<std::mutex> lock { mutex };
+        for (;;) {
+            wake.wait(lock, [this, seen] { return stopping || generation != seen; });
+            if (stopping) {
+                return;
+            }
+            seen = generation;
+            if (worker < active) {
+                lock.unlock();
+                job(job_block, worker);
+                lock.lock();
+            }
+            if (--pending == 0) {
+                done.notify_one();
+            }
+        }
+    }  // work()
+};  // WorkerPool
+
+#endif  // PARALLEL_H
@@ -0,0 +1,289 @@
+// Project identifier: 43DE0E0C4C76BFAA6D8C2F5AEAE0518A9C42CF4E
+
+#ifndef PERSISTENTPQ_H
+#define PERSISTENTPQ_H
+
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "Eecs281PQ.hpp"
+#include "PQStats.hpp"
+#include "Snapshot.hpp"
+
+// A persistent priority queue implemented as a leftist heap whose nodes
+// are never changed once built, and are shared between versions through
+// reference counts. Copying a PersistentPQ is O(1): the copy shares every
+// node. push() and pop() build O(log(n)) new nodes along the right spine
+// and leave every other version as it was, so a search can branch by
+// copying the queue, or through pushed() and popped(), which return the
+// new version and leave this one alone.
+//
+// The nodes are shared, not the PQ: versions can be used from different
+// threads, but one version cannot be changed from two at once.
+template<typename TYPE, typename COMP_FUNCTOR = std::less<TYPE>>
+class PersistentPQ : public Eecs281PQ<TYPE, COMP_FUNCTOR>, public PQCounters {
+    // This is a way to refer to the base class object.
+    using BaseClass = Eecs281PQ<TYPE, COMP_FUNCTOR>;
+
+    struct Node;
+    using Link = std::shared_ptr<Node>;
+
+public:
+    // Description: Construct an empty PQ with an optional comparison
+    //              functor.
+    // Runtime: O(1)
+    explicit PersistentPQ(COMP_FUNCTOR comp = COMP_FUNCTOR())
+        : BaseClass { comp } {}
+
+
+    // Description: Construct a PQ out of an iterator range with an optional
+    //              comparison functor.
+    // Runtime: O(n) where n is number of elements in range.
+    template<typename InputIterator>
+    PersistentPQ(InputIterator start, InputIterator end, COMP_FUNCTOR comp = COMP_FUNCTOR())
+        : BaseClass { comp } {
+        std::vector<TYPE> elements { start, end };
+        build(elements);
+    }  // PersistentPQ()
+
+
+    // Description: Copies share every node with the original, and moves
+    //              take them over.
+    // Runtime: O(1)
+    PersistentPQ(const PersistentPQ &) = default;
+    PersistentPQ(PersistentPQ &&) noexcept = default;
+    PersistentPQ &operator=(const PersistentPQ &) = default;
+    PersistentPQ &operator=(PersistentPQ &&) noexcept = default;
+
+
+    // Description: Destructor frees the nodes no other version shares.
+    virtual ~PersistentPQ() = default;
+
+
+    // Description: Assumes that all elements in this version are out of
+    //              order and rebuilds it. Other versions keep the nodes
+    //              they had.
+    // Runtime: O(n)
+    virtual void updatePriorities() {
+        this->countUpdate();
+        std::vector<TYPE> elements;
+        elements.reserve(count);
+        forEachNode([&elements](const Node &node) { elements.push_back(node.elt); });
+        build(elements);
+    }  // updatePriorities()
+
+
+    // Description: Add a new element to this version.
+    // Runtime: O(log(n))
+    virtual void push(const TYPE &val) {
+        root = merge(leaf(val), root);
+        ++count;
+    }  // push()
+
+
+    // Description: Remove the most extreme (defined by 'compare') element
+    //              from this version.
+    // Runtime: O(log(n))
+    virtual void pop() {
+        if (!root) {
+            return;
+        }
+        root = merge(root->left, root->right);
+        --count;
+    }  // pop()
+
+
+    // Description: Return the most extreme (defined by 'compare') element.
+    // Runtime: O(1)
+    virtual const TYPE &top() const { return root->elt; }
+
+
+    // Description: Get the number of elements in this version.
+    // Runtime: O(1)
+    [[nodiscard]] virtual std::size_t size() const { return count; }
+
+
+    // Description: Return true if this version is empty.
+    // Runtime: O(1)
+    [[nodiscard]] virtual bool empty() const { return count == 0; }
+
+
+    // Description: Return a new version with val added, leaving this one
+    //              as it is.
+    // Runtime: O(log(n))
+    [[nodiscard]] PersistentPQ pushed(const TYPE &val) const {
+        PersistentPQ next { *this };
+        next.push(val);
+        return next;
+    }  // pushed()
+
+
+    // Description: Return a new version without top(), leaving this one as
+    //              it is.
+    // Runtime: O(log(n))
+    [[nodiscard]] PersistentPQ popped() const {
+        PersistentPQ next { *this };
+        next.pop();
+        return next;
+    }  // popped()
+
+
+    // Description: Return a new version with the elements of both this one
+    //              and other, leaving both as they are.
+    // Runtime: O(log(n) + log(m)) where m is the size of other.
+    [[nodiscard]] PersistentPQ merged(const PersistentPQ &other) const {
+        PersistentPQ next { *this };
+        next.root = next.merge(root, other.root);
+        next.count += other.count;
+        return next;
+    }  // merged()
+
+
+    // Description: Return true if other is this version or a copy of it,
+    //              sharing the same nodes.
+    // Runtime: O(1)
+    [[nodiscard]] bool shares(const PersistentPQ &other) const {
+        return root == other.root && count == other.count;
+    }  // shares()
+
+
+    // Description: Write this version to os as a binary snapshot (see
+    //              Snapshot.hpp), as a flat list that starts with the most
+    //              extreme element. TYPE must be trivially copyable.
+    // Runtime: O(n)
+    void save(std::ostream &os) const {
+        std::vector<TYPE> elements;
+        elements.reserve(count);
+        forEachNode([&elements](const Node &node) { elements.push_back(node.elt); });
+        writeSnapshotHeader<TYPE>(os, elements.size(), SnapshotLayout::TopFirst);
+        writeSnapshotElements(os, elements.data(), elements.size());
+    }  // save()
+
+
+    // Description: Replace this version with a snapshot read from is, of
+    //              any layout. Other versions are not affected.
+    // Runtime: O(n)
+    void load(std::istream &is) {
+        SnapshotHeader header = readSnapshotHeader<TYPE>(is);
+        std::vector<TYPE> elements(header.count);
+        readSnapshotElements(is, elements.data(), elements.size());
+        build(elements);
+    }  // load()
+
+
+private:
+    // A node never changes once another node or version refers to it. Its
+    // rank is the length of its right spine, which is never longer than
+    // its left one, so the right spine is O(log(n)) long.
+    struct Node {
+        Node(const TYPE &val, Link left, Link right)
+            : elt { val }
+            , left { std::move(left) }
+            , right { std::move(right) } {
+            if (rank_of(this->left) < rank_of(this->right)) {
+                std::swap(this->left, this->right);
+            }
+            rank = rank_of(this->right) + 1;
+        }
+
+        // The left spine can be O(n) long, so children this node was the
+        // last owner of are released without recursion.
+        ~Node() {
+            if (!sole_owner(left) && !sole_owner(right)) {
+                return;
+            }
+            std::vector<Link> orphans;
+            orphans.push_back(std::move(left));
+            orphans.push_back(std::move(right));
+            while (!orphans.empty()) {
+                Link link = std::move(orphans.back());
+                orphans.pop_back();
+                if (sole_owner(link)) {
+                    orphans.push_back(std::move(link->left));
+                    orphans.push_back(std::move(link->right));
+                }
+            }
+        }
+
+        Node(const Node &) = delete;
+        Node &operator=(const Node &) = delete;
+
+        static bool sole_owner(const Link &link) { return link && link.use_count() == 1; }
+
+        TYPE elt;
+        Link left;
+        Link right;
+        std::size_t rank = 0;
+    };  // Node
+
+    Link root;
+    std::size_t count = 0;
+
+    static std::size_t rank_of(const Link &link) { return link ? link->rank : 0; }
+
+    Link leaf(const TYPE &val) {
+        this->countAllocations();
+        this->countCopies();
+        return std::make_shared<Node>(val, nullptr, nullptr);
+    }
+
+    // Merge along the right spines, copying each node on the way down
+    // rather than changing it.
+    Link merge(const Link &a, const Link &b) {
+        if (!a) {
+            return b;
+        }
+        if (!b) {
+            return a;
+        }
+        if (this->counted(this->compare)(a->elt, b->elt)) {
+            return merge(b, a);
+        }
+        this->countAllocations();
+        this->countCopies();
+        return std::make_shared<Node>(a->elt, a->left, merge(a->right, b));
+    }
+
+    // Replace this version with the elements, merging them in pairs round
+    // by round.
+    void build(const std::vector<TYPE> &elements) {
+        std::deque<Link> heaps;
+        for (const TYPE &element : elements) {
+            heaps.push_back(leaf(element));
+        }
+        while (heaps.size() > 1) {
+            Link a = std::move(heaps.front());
+            heaps.pop_front();
+            Link b = std::move(heaps.front());
+            heaps.pop_front();
+            heaps.push_back(merge(a, b));
+        }
+        root = heaps.empty() ? nullptr : std::move(heaps.front());
+        count = elements.size();
+    }
+
+    // Visit every node of this version, parents before children, without
+    // recursion.
+    template<typename Visitor>
+    void forEachNode(Visitor visitor) const {
+        std::vector<const Node *> stack;
+        if (root) {
+            stack.push_back(root.get());
+        }
+        while (!stack.empty()) {
+            const Node *node = stack.back();
+            stack.pop_back();
+            visitor(*node);
+            for (const Link *child : { &node->left, &node->right }) {
+                if (*child) {
+                    stack.push_back(child->get());
+                }
+            }
+        }
+    }
+};  // PersistentPQ
+
+#endif  // PERSISTENTPQ_H
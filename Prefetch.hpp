@@ -0,0 +1,18 @@
+// Project identifier: 43DE0E0C4C76BFAA6D8C2F5AEAE0518A9C42CF4E
+
+#ifndef PREFETCH_H
+#define PREFETCH_H
+
+// Description: Hint that the cache line holding addr is about to be read,
+//              so the load overlaps with work already in flight. Compiles
+//              to nothing on compilers without the builtin, or when built
+//              with -DPQ_NO_PREFETCH to measure what the hint is worth.
+inline void prefetchRead(const void *addr) {
+#if defined(__GNUC__) && !defined(PQ_NO_PREFETCH)
+    __builtin_prefetch(addr, 0, 3);
+#else
+    (void)addr;
+#endif
+}  // prefetchRead()
+
+#endif  // PREFETCH_H
@@ -0,0 +1,133 @@
+// Project identifier: 43DE0E0C4C76BFAA6D8C2F5AEAE0518A9C42CF4E
+
+#ifndef PROJECTION_H
+#define PROJECTION_H
+
+#include <cstddef>
+#include <functional>
+#include <type_traits>
+
+// Comparators that order objects by one of their members, for the common
+// "max by field" and "min by field" cases:
+//
+//     BinaryPQ<Job, by_key<&Job::deadline, std::greater<>>> pq;  // Earliest deadline first
+//     UnorderedPQ<Job, max_by_key<&Job::priority>> pq;
+//
+// by_key works as a plain comparator with every PQ. It also says what it
+// compares, so a PQ can tell at compile time that only the keys matter and
+// work on them directly: UnorderedPQ and UnorderedFastPQ scan the keys of
+// small elements for the extreme with a loop the compiler can vectorize
+// (see scanKeys()). A stateless key comparison adds nothing to the size of
+// by_key.
+//
+// Any comparator can opt in by providing what by_key does: object_type,
+// key_type, a static key(const object_type &) and keyComp().
+
+template<typename MEMBER_POINTER>
+struct MemberPointerTraits;
+
+template<typename CLASS, typename MEMBER>
+struct MemberPointerTraits<MEMBER CLASS::*> {
+    using class_type = CLASS;
+    using member_type = MEMBER;
+};
+
+
+template<auto MEMBER, typename KEY_COMP = std::less<>>
+class by_key : private KEY_COMP {
+public:
+    using object_type = typename MemberPointerTraits<decltype(MEMBER)>::class_type;
+    using key_type = typename MemberPointerTraits<decltype(MEMBER)>::member_type;
+    using key_compare = KEY_COMP;
+
+    by_key() = default;
+    explicit by_key(KEY_COMP comp)
+        : KEY_COMP { comp } {}
+
+    // Description: Return the key of obj.
+    static const key_type &key(const object_type &obj) { return obj.*MEMBER; }
+
+    // Description: Return the comparison used on keys.
+    const KEY_COMP &keyComp() const { return *this; }
+
+    // Description: Return true if a is less extreme than b, by their keys.
+    bool operator()(const object_type &a, const object_type &b) const { return keyComp()(key(a), key(b)); }
+};  // by_key
+
+// The element with the greatest key is the most extreme.
+template<auto MEMBER>
+using max_by_key = by_key<MEMBER, std::less<>>;
+
+// The element with the least key is the most extreme.
+template<auto MEMBER>
+using min_by_key = by_key<MEMBER, std::greater<>>;
+
+
+// Whether COMP compares through keys, as by_key does.
+template<typename COMP, typename = void>
+struct IsProjection : std::false_type {};
+
+template<typename COMP>
+struct IsProjection<COMP, std::void_t<typename COMP::object_type, typename COMP::key_type,
+                                      decltype(COMP::key(std::declval<const typename COMP::object_type &>())),
+                                      decltype(std::declval<const COMP &>().keyComp())>> : std::true_type {};
+
+template<typename COMP>
+constexpr bool kIsProjection = IsProjection<COMP>::value;
+
+
+// Whether scanKeys() can find the extreme under COMP: COMP compares
+// integral keys with std::less or std::greater, so the extreme key is a
+// plain max or min.
+template<typename COMP, typename = void>
+struct CanScanKeys : std::false_type {};
+
+template<typename COMP>
+struct CanScanKeys<COMP, std::enable_if_t<kIsProjection<COMP>>> {
+    using Key = std::remove_cv_t<typename COMP::key_type>;
+    using KeyComp = std::decay_t<decltype(std::declval<const COMP &>().keyComp())>;
+
+    static constexpr bool value = std::is_integral<Key>::value
+                               && (std::is_same<KeyComp, std::less<>>::value
+                                   || std::is_same<KeyComp, std::less<Key>>::value
+                                   || std::is_same<KeyComp, std::greater<>>::value
+                                   || std::is_same<KeyComp, std::greater<Key>>::value);
+};
+
+template<typename COMP>
+constexpr bool kCanScanKeys = CanScanKeys<COMP>::value;
+
+// The widest element a PQ scans by key. The keys of wider elements are too
+// far apart for vector loads to pay, and the comparator loop is faster.
+constexpr std::size_t kScanKeysMaxSize = 16;
+
+// Whether a PQ of TYPE ordered by COMP should find its extreme with
+// scanKeys().
+template<typename TYPE, typename COMP>
+constexpr bool kScanKeys = kCanScanKeys<COMP> && sizeof(TYPE) <= kScanKeysMaxSize;
+
+
+// Description: Return the index of the most extreme of data[0, n) by comp,
+//              the first one if several tie, as a linear scan with comp
+//              would. One pass finds the extreme key as a max or min
+//              reduction, which the compiler can vectorize, and a second
+//              finds the first element that has it. Requires n > 0 and
+//              kCanScanKeys<COMP>.
+// Runtime: O(n)
+template<typename TYPE, typename COMP>
+std::size_t scanKeys(const TYPE *data, std::size_t n, const COMP &comp) {
+    static_assert(kCanScanKeys<COMP>, "scanKeys() needs integral keys compared with less or greater");
+    const auto &key_comp = comp.keyComp();
+    auto best = COMP::key(data[0]);
+    for (std::size_t i = 1; i < n; ++i) {
+        auto key = COMP::key(data[i]);
+        best = key_comp(best, key) ? key : best;
+    }
+    std::size_t index = 0;
+    while (COMP::key(data[index]) != best) {
+        ++index;
+    }
+    return index;
+}  // scanKeys()
+
+#endif  // PROJECTION_H
@@ -0,0 +1,358 @@
+// Project identifier: 43DE0E0C4C76BFAA6D8C2F5AEAE0518A9C42CF4E
+
+#ifndef SHAREDBINARYPQ_H
+#define SHAREDBINARYPQ_H
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "Eecs281PQ.hpp"
+#include "HeapSift.hpp"
+
+// A binary heap in a POSIX shared-memory segment, so that independent
+// processes on one host can push to and pop from the same queue directly,
+// without a broker. Every process opens the segment by name; the first one
+// creates it with a fixed capacity. The array is laid out like BinaryPQ's
+// data vector (slot 0 unused) and every operation holds a process-shared,
+// robust mutex stored in the segment.
+//
+// If a process dies holding the lock, the next process to take it restores
+// the heap invariant with one O(n) rebuild, as MappedBinaryPQ does after a
+// crash. The rebuild cannot undo a half-finished write, so an element that
+// was being pushed, popped or swapped at the time may be lost or
+// duplicated.
+//
+// TYPE must be trivially copyable, and every process must use the same TYPE
+// and COMP_FUNCTOR. top() returns a reference into the segment that another
+// process may change at any time; workers should use tryPop() instead,
+// which removes and returns the top element in one step.
+template<typename TYPE, typename COMP_FUNCTOR = std::less<TYPE>>
+class SharedBinaryPQ : public Eecs281PQ<TYPE, COMP_FUNCTOR> {
+    static_assert(std::is_trivially_copyable<TYPE>::value,
+                  "SharedBinaryPQ stores TYPE as raw bytes in shared memory");
+
+    // This is a way to refer to the base class object.
+    using BaseClass = Eecs281PQ<TYPE, COMP_FUNCTOR>;
+
+public:
+    static constexpr std::size_t kDefaultCapacity = 1 << 16;  // NOLINT: arbitrary size
+
+    // How long to wait by default for another process to finish creating
+    // the heap before concluding that it died part way.
+    static constexpr std::chrono::milliseconds kAttachTimeout { 5000 };  // NOLINT: arbitrary wait
+
+    // Description: Open the shared heap called name (a POSIX shared-memory
+    //              name such as "/jobs"), creating an empty one that can
+    //              hold capacity elements if it does not exist yet. The
+    //              capacity of an existing heap is kept. Throws
+    //              std::runtime_error if the process creating the heap does
+    //              not finish within attach_timeout.
+    // Runtime: O(1)
+    explicit SharedBinaryPQ(const std::string &name, std::size_t capacity = kDefaultCapacity,
+                            COMP_FUNCTOR comp = COMP_FUNCTOR(),
+                            std::chrono::milliseconds attach_timeout = kAttachTimeout)
+        : BaseClass { comp } {
+        fd = ::shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);  // NOLINT: rw-------
+        if (fd >= 0) {
+            create(capacity);
+            return;
+        }
+        if (errno != EEXIST) {
+            throw std::runtime_error("SharedBinaryPQ: cannot create " + name);
+        }
+        fd = ::shm_open(name.c_str(), O_RDWR, 0);
+        if (fd < 0) {
+            throw std::runtime_error("SharedBinaryPQ: cannot open " + name);
+        }
+        attach(name, attach_timeout);
+    }  // SharedBinaryPQ()
+
+
+    // Description: Unmap the segment. The heap stays in shared memory until
+    //              remove() is called and every process has closed it.
+    // Runtime: O(1)
+    virtual ~SharedBinaryPQ() {
+        ::munmap(base, mapped_bytes);
+        ::close(fd);
+    }  // ~SharedBinaryPQ()
+
+
+    // Description: Each object is one process's view of the segment, so
+    //              copying and moving are not allowed.
+    SharedBinaryPQ(const SharedBinaryPQ &) = delete;
+    SharedBinaryPQ(SharedBinaryPQ &&) = delete;
+    SharedBinaryPQ &operator=(const SharedBinaryPQ &) = delete;
+    SharedBinaryPQ &operator=(SharedBinaryPQ &&) = delete;
+
+
+    // Description: Remove the shared heap called name. Processes that have
+    //              it open keep using it; the next one to open the name
+    //              gets a new, empty heap.
+    static void remove(const std::string &name) { ::shm_unlink(name.c_str()); }
+
+
+    // Description: Assumes that all elements inside the heap are out of order
+    //              and 'rebuilds' the heap by fixing the heap invariant.
+    // Runtime: O(n)
+    virtual void updatePriorities() {
+        Lock lock { *this };
+        heapify();
+    }  // updatePriorities()
+
+
+    // Description: Add a new element to the heap. Throws std::length_error
+    //              if the heap is full.
+    // Runtime: O(log(n))
+    virtual void push(const TYPE &val) {
+        if (!tryPush(val)) {
+            throw std::length_error("SharedBinaryPQ: heap is full");
+        }
+    }  // push()
+
+
+    // Description: Add a new element to the heap, or return false if the
+    //              heap is full.
+    // Runtime: O(log(n))
+    bool tryPush(const TYPE &val) {
+        Lock lock { *this };
+        if (header->count + 1 >= header->capacity) {
+            return false;
+        }
+        begin_op();
+        data[header->count + 1] = val;
+        ++header->count;
+        fix_up(static_cast<std::size_t>(header->count));
+        end_op();
+        return true;
+    }  // tryPush()
+
+
+    // Description: Remove the most extreme (defined by 'compare') element
+    //              from the heap, if any.
+    // Runtime: O(log(n))
+    virtual void pop() {
+        TYPE discarded;
+        tryPop(discarded);
+    }  // pop()
+
+
+    // Description: Remove the most extreme (defined by 'compare') element
+    //              from the heap and copy it to out, or return false if the
+    //              heap is empty.
+    // Runtime: O(log(n))
+    bool tryPop(TYPE &out) {
+        Lock lock { *this };
+        if (header->count == 0) {
+            return false;
+        }
+        begin_op();
+        out = data[1];
+        data[1] = data[header->count--];
+        fix_down(1);
+        end_op();
+        return true;
+    }  // tryPop()
+
+
+    // Description: Return the most extreme (defined by 'compare') element of
+    //              the heap. Only meaningful while no other process changes
+    //              the heap; see tryPop().
+    // Runtime: O(1)
+    virtual const TYPE &top() const {
+        Lock lock { *this };
+        return data[1];
+    }  // top()
+
+
+    // Description: Get the number of elements in the heap.
+    // Runtime: O(1)
+    [[nodiscard]] virtual std::size_t size() const {
+        Lock lock { *this };
+        return static_cast<std::size_t>(header->count);
+    }  // size()
+
+
+    // Description: Return true if the heap is empty.
+    // Runtime: O(1)
+    [[nodiscard]] virtual bool empty() const { return size() == 0; }
+
+
+    // Description: Get the number of elements the heap can hold.
+    // Runtime: O(1)
+    [[nodiscard]] std::size_t capacity() const { return static_cast<std::size_t>(header->capacity) - 1; }
+
+
+    // Description: Return true if the stored array satisfies the heap
+    //              invariant.
+    // Runtime: O(n)
+    [[nodiscard]] bool isHeap() const {
+        Lock lock { *this };
+        for (std::size_t i = 2; i <= header->count; ++i) {
+            if (this->compare(data[i / 2], data[i])) {
+                return false;
+            }
+        }
+        return true;
+    }  // isHeap()
+
+
+private:
+    // Layout of the first kHeaderBytes of the segment. The creator sets
+    // ready last, so other processes wait on it before using the rest.
+    struct Header {
+        std::atomic<std::uint32_t> ready { 0 };
+        std::uint64_t magic = kMagic;
+        std::uint64_t elt_size = sizeof(TYPE);
+        std::uint64_t count = 0;
+        std::uint64_t capacity = 0;  // Slots in the array, including slot 0
+        std::uint64_t clean = 1;     // 0 while an operation is in progress
+        pthread_mutex_t mutex;
+    };
+
+    static constexpr std::uint64_t kMagic = 0x3138325142505348;  // NOLINT: "HSPBQ281"
+    static constexpr std::size_t kHeaderBytes = 128;             // NOLINT: two cache lines
+    static_assert(sizeof(Header) <= kHeaderBytes, "header must fit before the array");
+    static_assert(alignof(TYPE) <= kHeaderBytes, "array must stay aligned after the header");
+    static_assert(std::atomic<std::uint32_t>::is_always_lock_free, "ready flag must work across processes");
+
+    int fd = -1;
+    void *base = nullptr;
+    std::size_t mapped_bytes = 0;
+    Header *header = nullptr;
+    TYPE *data = nullptr;
+
+    // Holds the mutex for its lifetime, and rebuilds the heap if the last
+    // process to hold it died during an operation. Throws if the mutex
+    // cannot be taken at all.
+    class Lock {
+    public:
+        explicit Lock(const SharedBinaryPQ &pq)
+            : mutex { &pq.header->mutex } {
+            int status = ::pthread_mutex_lock(mutex);
+            if (status == EOWNERDEAD) {
+                if (pq.header->clean == 0) {
+                    const_cast<SharedBinaryPQ &>(pq).heapify();
+                    pq.header->clean = 1;
+                }
+                ::pthread_mutex_consistent(mutex);
+            } else if (status != 0) {
+                throw std::runtime_error(std::string("SharedBinaryPQ: cannot lock heap: ") + std::strerror(status));
+            }
+        }
+        ~Lock() { ::pthread_mutex_unlock(mutex); }
+
+        Lock(const Lock &) = delete;
+        Lock &operator=(const Lock &) = delete;
+
+    private:
+        pthread_mutex_t *mutex;
+    };  // Lock
+
+    void map(std::size_t bytes) {
+        mapped_bytes = bytes;
+        base = ::mmap(nullptr, mapped_bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (base == MAP_FAILED) {  // NOLINT: MAP_FAILED is a C-style cast
+            ::close(fd);
+            throw std::runtime_error("SharedBinaryPQ: cannot map segment");
+        }
+        header = static_cast<Header *>(base);
+        data = reinterpret_cast<TYPE *>(static_cast<char *>(base) + kHeaderBytes);
+    }  // map()
+
+    // Size and initialize a segment this process just created.
+    void create(std::size_t capacity) {
+        std::size_t bytes = kHeaderBytes + (capacity + 1) * sizeof(TYPE);
+        if (::ftruncate(fd, static_cast<off_t>(bytes)) != 0) {
+            ::close(fd);
+            throw std::runtime_error("SharedBinaryPQ: cannot size segment");
+        }
+        map(bytes);
+        new (header) Header {};
+        header->capacity = capacity + 1;
+
+        pthread_mutexattr_t attr;
+        ::pthread_mutexattr_init(&attr);
+        ::pthread_mutexattr_setpshared(&attr, PTHREAD_PROCESS_SHARED);
+        ::pthread_mutexattr_setrobust(&attr, PTHREAD_MUTEX_ROBUST);
+        ::pthread_mutex_init(&header->mutex, &attr);
+        ::pthread_mutexattr_destroy(&attr);
+
+        header->ready.store(1, std::memory_order_release);
+    }  // create()
+
+    // Map a segment another process created, waiting up to timeout for it
+    // to finish sizing and initializing it.
+    void attach(const std::string &name, std::chrono::milliseconds timeout) {
+        auto deadline = std::chrono::steady_clock::now() + timeout;
+        auto wait = [this, &name, deadline] {
+            if (std::chrono::steady_clock::now() > deadline) {
+                if (base) {
+                    ::munmap(base, mapped_bytes);
+                }
+                ::close(fd);
+                throw std::runtime_error("SharedBinaryPQ: " + name + " was never initialized; its creator may have died");
+            }
+            ::sched_yield();
+        };
+
+        struct stat info {};
+        while (static_cast<std::size_t>(info.st_size) < kHeaderBytes) {
+            if (::fstat(fd, &info) != 0) {
+                ::close(fd);
+                throw std::runtime_error("SharedBinaryPQ: cannot stat " + name);
+            }
+            if (static_cast<std::size_t>(info.st_size) < kHeaderBytes) {
+                wait();
+            }
+        }
+        map(static_cast<std::size_t>(info.st_size));
+        while (header->ready.load(std::memory_order_acquire) == 0) {
+            wait();
+        }
+        if (header->magic != kMagic || header->elt_size != sizeof(TYPE)
+            || kHeaderBytes + header->capacity * sizeof(TYPE) > mapped_bytes) {
+            ::munmap(base, mapped_bytes);
+            ::close(fd);
+            throw std::runtime_error("SharedBinaryPQ: " + name + " is not a heap of this type");
+        }
+    }  // attach()
+
+    // Bracket every mutation, so that a process that dies in between leaves
+    // clean at 0. Nothing else in this process reads clean while the lock
+    // is held, so the fences keep the compiler from dropping the first
+    // store or moving the heap's stores across either one.
+    void begin_op() {
+        header->clean = 0;
+        std::atomic_signal_fence(std::memory_order_seq_cst);
+    }  // begin_op()
+
+    void end_op() {
+        std::atomic_signal_fence(std::memory_order_seq_cst);
+        header->clean = 1;
+    }  // end_op()
+
+    void heapify() { heapBuild(data, static_cast<std::size_t>(header->count), this->compare); }
+
+    void fix_up(std::size_t index) { heapSiftUp(data, index, this->compare); }
+
+    void fix_down(std::size_t index) {
+        heapSiftDown(data, static_cast<std::size_t>(header->count), index, this->compare);
+    }  // fix_down()
+};  // SharedBinaryPQ
+
+#endif  // SHAREDBINARYPQ_H
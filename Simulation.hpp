@@ -0,0 +1,188 @@
+// Project identifier: 43DE0E0C4C76BFAA6D8C2F5AEAE0518A9C42CF4E
+
+#ifndef SIMULATION_H
+#define SIMULATION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "BinaryPQ.hpp"
+#include "TimingWheelPQ.hpp"
+
+// A discrete-event simulation kernel: events carry a PAYLOAD and a time in
+// integer ticks, and handling an event may schedule more of them.
+//
+// Payloads are constructed in place when they are scheduled and stay put
+// until they have been handled, so they are never copied or moved; the
+// event queue only holds a small SimEvent that refers to one. The queue is
+// any PQ over SimEvents ordered by SimEventOrder: BinaryPQ by default,
+// PairingPQ, or CalendarQueue, the timing wheel keyed by event time.
+//
+// run() pops every event due at the earliest time and hands them to the
+// handler together, as one Batch, in the order they were scheduled.
+// Events the handler schedules for that same time go in the next batch.
+
+// Simulated time, in ticks.
+using SimTime = std::uint64_t;
+
+// What the event queue holds for each pending event.
+struct SimEvent {
+    SimTime time;
+    std::uint64_t sequence;  // Scheduling order, to break ties in time
+    std::uint32_t slot;      // Where the payload is
+};
+
+// Earlier events have higher priority, and then those scheduled first.
+struct SimEventOrder {
+    bool operator()(const SimEvent &a, const SimEvent &b) const {
+        return a.time != b.time ? a.time > b.time : a.sequence > b.sequence;
+    }
+};
+
+struct SimEventTime {
+    SimTime operator()(const SimEvent &event) const { return event.time; }
+};
+
+// A calendar queue for the kernel: a TimingWheelPQ with a bucket per tick
+// at its lowest level.
+template<typename TYPE, typename COMP_FUNCTOR>
+using CalendarQueue = TimingWheelPQ<TYPE, COMP_FUNCTOR, SimEventTime>;
+
+
+template<typename PAYLOAD, template<typename...> typename QUEUE = BinaryPQ>
+class Simulation {
+public:
+    using Queue = QUEUE<SimEvent, SimEventOrder>;
+
+    // The events due at one time, as a range of PAYLOAD &.
+    class Batch {
+    public:
+        class iterator {
+        public:
+            iterator(Simulation *sim, std::vector<std::uint32_t>::const_iterator it) : sim { sim }, it { it } {}
+            PAYLOAD &operator*() const { return *sim->payloads[*it]; }
+            PAYLOAD *operator->() const { return &**this; }
+            iterator &operator++() {
+                ++it;
+                return *this;
+            }
+            bool operator==(const iterator &other) const { return it == other.it; }
+            bool operator!=(const iterator &other) const { return it != other.it; }
+
+        private:
+            Simulation *sim;
+            std::vector<std::uint32_t>::const_iterator it;
+        };
+
+        [[nodiscard]] iterator begin() const { return { sim, sim->batch.cbegin() }; }
+        [[nodiscard]] iterator end() const { return { sim, sim->batch.cend() }; }
+        [[nodiscard]] std::size_t size() const { return sim->batch.size(); }
+        [[nodiscard]] SimTime time() const { return sim->clock; }
+
+    private:
+        friend class Simulation;
+        explicit Batch(Simulation *sim) : sim { sim } {}
+        Simulation *sim;
+    };
+
+
+    // Description: Construct a simulation with no events, at time start.
+    // Runtime: O(1)
+    explicit Simulation(SimTime start = 0) : clock { start } {}
+
+
+    // Payloads may be move-only, and are never copied; neither is a
+    // simulation.
+    Simulation(const Simulation &) = delete;
+    Simulation &operator=(const Simulation &) = delete;
+
+
+    // Description: Schedule an event at time at, constructing its payload
+    //              in place from args. Throws std::invalid_argument if at
+    //              is earlier than now().
+    // Runtime: The queue's push()
+    template<typename... Args>
+    void schedule(SimTime at, Args &&...args) {
+        if (at < clock) {
+            throw std::invalid_argument("Simulation::schedule(): event scheduled in the past");
+        }
+        std::uint32_t slot = 0;
+        if (free_slots.empty()) {
+            slot = static_cast<std::uint32_t>(payloads.size());
+            payloads.emplace_back(std::in_place, std::forward<Args>(args)...);
+        } else {
+            slot = free_slots.back();
+            free_slots.pop_back();
+            payloads[slot].emplace(std::forward<Args>(args)...);
+        }
+        queue.push(SimEvent { at, next_sequence++, slot });
+    }  // schedule()
+
+
+    // Description: Handle events in time order until there are none left
+    //              or the next one is after until. handler is called as
+    //              handler(simulation, batch) once per time with events,
+    //              and may schedule more. Returns the number of events
+    //              handled.
+    // Runtime: O(events handled * the queue's pop())
+    template<typename Handler>
+    std::size_t run(Handler handler, SimTime until = std::numeric_limits<SimTime>::max()) {
+        std::size_t handled = 0;
+        while (!queue.empty() && queue.top().time <= until) {
+            clock = queue.top().time;
+            while (!queue.empty() && queue.top().time == clock) {
+                batch.push_back(queue.top().slot);
+                queue.pop();
+            }
+            handled += batch.size();
+            // The batch is done with even if the handler throws.
+            struct Release {
+                Simulation *sim;
+                ~Release() { sim->release_batch(); }
+            } release { this };
+            handler(*this, Batch { this });
+        }
+        return handled;
+    }  // run()
+
+
+    // Description: Return the time of the batch being handled, or of the
+    //              last one.
+    // Runtime: O(1)
+    [[nodiscard]] SimTime now() const { return clock; }
+
+
+    // Description: Return the number of events not yet handled.
+    // Runtime: O(1)
+    [[nodiscard]] std::size_t size() const { return queue.size(); }
+
+
+    // Description: Return true if no events are waiting.
+    // Runtime: O(1)
+    [[nodiscard]] bool empty() const { return queue.empty(); }
+
+
+private:
+    Queue queue;
+    std::deque<std::optional<PAYLOAD>> payloads;  // Elements never move as it grows
+    std::vector<std::uint32_t> free_slots;
+    std::vector<std::uint32_t> batch;  // Slots of the batch being handled
+    SimTime clock;
+    std::uint64_t next_sequence = 0;
+
+    void release_batch() {
+        for (std::uint32_t slot : batch) {
+            payloads[slot].reset();
+            free_slots.push_back(slot);
+        }
+        batch.clear();
+    }
+};  // Simulation
+
+#endif  // SIMULATION_H
@@ -0,0 +1,208 @@
+// Project identifier: 43DE0E0C4C76BFAA6D8C2F5AEAE0518A9C42CF4E
+
+#ifndef SMALLPQ_H
+#define SMALLPQ_H
+
+#include <algorithm>
+#include <array>
+#include <utility>
+#include <vector>
+
+#include "Eecs281PQ.hpp"
+#include "PQStats.hpp"
+#include "Snapshot.hpp"
+
+// A priority queue that keeps up to N elements inline, inside the object,
+// so that a PQ that stays small never allocates. While small, the elements
+// are unordered and searched linearly, as in UnorderedFastPQ, with the
+// index of the most extreme one kept up to date. Pushing element N + 1
+// moves them all to a binary heap in a vector, which is used until the PQ
+// is empty again; the vector keeps its capacity for the next time.
+//
+// To pass it where a PQ<TYPE, COMP_FUNCTOR> template is expected, use an
+// alias template that fixes N.
+template<typename TYPE, typename COMP_FUNCTOR = std::less<TYPE>, std::size_t N = 8>
+class SmallPQ : public Eecs281PQ<TYPE, COMP_FUNCTOR>, public PQCounters {
+    // This is a way to refer to the base class object.
+    using BaseClass = Eecs281PQ<TYPE, COMP_FUNCTOR>;
+
+    static_assert(N > 0, "SmallPQ needs room for at least one element inline");
+
+public:
+    static constexpr std::size_t kInlineCapacity = N;
+
+    // Description: Construct an empty PQ with an optional comparison functor.
+    // Runtime: O(1)
+    explicit SmallPQ(COMP_FUNCTOR comp = COMP_FUNCTOR())
+        : BaseClass { comp } {}
+
+
+    // Description: Construct a PQ out of an iterator range with an optional
+    //              comparison functor.
+    // Runtime: O(n) where n is number of elements in range.
+    template<typename InputIterator>
+    SmallPQ(InputIterator start, InputIterator end, COMP_FUNCTOR comp = COMP_FUNCTOR())
+        : BaseClass { comp } {
+        while (start != end && count < N) {
+            small[count++] = *start;
+            ++start;
+        }
+        if (start != end) {
+            spill();
+            heap.insert(heap.end(), start, end);
+        }
+        this->countCopies(size());
+        rebuild();
+    }  // SmallPQ()
+
+
+    // Description: Destructor, copy and move need no code; the inline array
+    //              and the vector are handled automatically.
+    virtual ~SmallPQ() = default;
+
+    SmallPQ(const SmallPQ &) = default;
+    SmallPQ(SmallPQ &&) noexcept = default;
+    SmallPQ &operator=(const SmallPQ &) = default;
+    SmallPQ &operator=(SmallPQ &&) noexcept = default;
+
+
+    // Description: Assumes that all elements inside the PQ are out of order
+    //              and restores the PQ invariant.
+    // Runtime: O(n)
+    virtual void updatePriorities() {
+        this->countUpdate();
+        rebuild();
+    }  // updatePriorities()
+
+
+    // Description: Add a new element to the PQ.
+    // Runtime: O(1) while inline, O(log(n)) once spilled
+    virtual void push(const TYPE &val) {
+        this->countCopies();
+        if (isInline() && count < N) {
+            small[count] = val;
+            if (count == 0 || this->counted(this->compare)(small[extreme], val)) {
+                extreme = count;
+            }
+            ++count;
+            return;
+        }
+        if (isInline()) {
+            spill();
+        }
+        heap.push_back(val);
+        std::push_heap(heap.begin(), heap.end(), this->counted(this->compare));
+    }  // push()
+
+
+    // Description: Remove the most extreme (defined by 'compare') element
+    //              from the PQ.
+    // Runtime: O(N) while inline, O(log(n)) once spilled
+    virtual void pop() {
+        if (!isInline()) {
+            std::pop_heap(heap.begin(), heap.end(), this->counted(this->compare));
+            heap.pop_back();
+            return;
+        }
+        if (count == 0) {
+            return;
+        }
+        --count;
+        if (extreme != count) {
+            small[extreme] = std::move(small[count]);
+            this->countMoves();
+        }
+        find_extreme();
+    }  // pop()
+
+
+    // Description: Return the most extreme (defined by 'compare') element of
+    //              the PQ.
+    // Runtime: O(1)
+    virtual const TYPE &top() const { return isInline() ? small[extreme] : heap.front(); }
+
+
+    // Description: Get the number of elements in the PQ.
+    // Runtime: O(1)
+    [[nodiscard]] virtual std::size_t size() const { return isInline() ? count : heap.size(); }
+
+
+    // Description: Return true if the PQ is empty.
+    // Runtime: O(1)
+    [[nodiscard]] virtual bool empty() const { return size() == 0; }
+
+
+    // Description: Return true if the elements are stored inline, i.e. the
+    //              PQ has not outgrown N elements since it was last empty.
+    // Runtime: O(1)
+    [[nodiscard]] bool isInline() const { return heap.empty(); }
+
+
+    // Description: Write the PQ to os as a binary snapshot (see Snapshot.hpp).
+    //              TYPE must be trivially copyable.
+    // Runtime: O(n)
+    void save(std::ostream &os) const {
+        writeSnapshotHeader<TYPE>(os, size(), SnapshotLayout::Unordered);
+        if (isInline()) {
+            writeSnapshotElements(os, small.data(), count);
+        } else {
+            writeSnapshotElements(os, heap.data(), heap.size());
+        }
+    }  // save()
+
+
+    // Description: Replace the contents of the PQ with a snapshot read from
+    //              is, of any layout.
+    // Runtime: O(n)
+    void load(std::istream &is) {
+        SnapshotHeader header = readSnapshotHeader<TYPE>(is);
+        std::vector<TYPE> loaded(header.count);
+        readSnapshotElements(is, loaded.data(), loaded.size());
+        heap.clear();
+        count = 0;
+        if (loaded.size() <= N) {
+            std::copy(loaded.begin(), loaded.end(), small.begin());
+            count = loaded.size();
+        } else {
+            heap.swap(loaded);
+        }
+        rebuild();
+    }  // load()
+
+
+private:
+    std::array<TYPE, N> small {};
+    std::size_t count = 0;    // Elements in small, while inline
+    std::size_t extreme = 0;  // Index in small of the most extreme element
+    std::vector<TYPE> heap;   // Every element, once spilled
+
+    // Move the inline elements to the heap.
+    void spill() {
+        heap.reserve(std::max(heap.capacity(), 2 * N));
+        for (std::size_t i = 0; i < count; ++i) {
+            heap.push_back(std::move(small[i]));
+        }
+        this->countMoves(count);
+        count = 0;
+        std::make_heap(heap.begin(), heap.end(), this->counted(this->compare));
+    }
+
+    void find_extreme() {
+        extreme = 0;
+        for (std::size_t i = 1; i < count; ++i) {
+            if (this->counted(this->compare)(small[extreme], small[i])) {
+                extreme = i;
+            }
+        }
+    }
+
+    void rebuild() {
+        if (isInline()) {
+            find_extreme();
+        } else {
+            std::make_heap(heap.begin(), heap.end(), this->counted(this->compare));
+        }
+    }
+};  // SmallPQ
+
+#endif  // SMALLPQ_H
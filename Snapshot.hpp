@@ -0,0 +1,77 @@
+// Project identifier: 43DE0E0C4C76BFAA6D8C2F5AEAE0518A9C42CF4E
+
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <type_traits>
+
+// Binary snapshots shared by every PQ's save() and load(). A snapshot is a
+// fixed header followed by the elements as raw bytes, so TYPE must be
+// trivially copyable. The header records how the elements are ordered, so
+// a PQ can skip rebuilding when the layout is one it can use as-is, and
+// any PQ can load any other PQ's snapshot by rebuilding. load() reads
+// every element before it replaces anything, so a snapshot that turns out
+// to be truncated or of another type leaves the PQ as it was.
+enum class SnapshotLayout : std::uint64_t {
+    Unordered = 0,  // No particular order
+    Heap = 1,       // Binary heap order, most extreme element first
+    Sorted = 2,     // Least extreme element first
+    TopFirst = 3,   // Most extreme element first, the rest in any order
+};
+
+struct SnapshotHeader {
+    std::uint64_t magic = kSnapshotMagic;
+    std::uint64_t elt_size = 0;
+    std::uint64_t count = 0;
+    SnapshotLayout layout = SnapshotLayout::Unordered;
+
+    static constexpr std::uint64_t kSnapshotMagic = 0x3138325051534e50;  // NOLINT: "PNSQP281"
+};
+
+
+// Description: Write a snapshot header for count elements of TYPE.
+template<typename TYPE>
+void writeSnapshotHeader(std::ostream &os, std::size_t count, SnapshotLayout layout) {
+    static_assert(std::is_trivially_copyable<TYPE>::value, "snapshots store TYPE as raw bytes");
+    SnapshotHeader header;
+    header.elt_size = sizeof(TYPE);
+    header.count = count;
+    header.layout = layout;
+    os.write(reinterpret_cast<const char *>(&header), sizeof(header));
+}  // writeSnapshotHeader()
+
+
+// Description: Read a snapshot header, checking that it holds TYPE.
+template<typename TYPE>
+SnapshotHeader readSnapshotHeader(std::istream &is) {
+    static_assert(std::is_trivially_copyable<TYPE>::value, "snapshots store TYPE as raw bytes");
+    SnapshotHeader header;
+    if (!is.read(reinterpret_cast<char *>(&header), sizeof(header))
+        || header.magic != SnapshotHeader::kSnapshotMagic || header.elt_size != sizeof(TYPE)) {
+        throw std::runtime_error("not a PQ snapshot of this element type");
+    }
+    return header;
+}  // readSnapshotHeader()
+
+
+// Description: Write n contiguous elements in one block.
+template<typename TYPE>
+void writeSnapshotElements(std::ostream &os, const TYPE *elts, std::size_t n) {
+    os.write(reinterpret_cast<const char *>(elts), static_cast<std::streamsize>(n * sizeof(TYPE)));
+}  // writeSnapshotElements()
+
+
+// Description: Read n contiguous elements in one block.
+template<typename TYPE>
+void readSnapshotElements(std::istream &is, TYPE *elts, std::size_t n) {
+    if (!is.read(reinterpret_cast<char *>(elts), static_cast<std::streamsize>(n * sizeof(TYPE)))) {
+        throw std::runtime_error("PQ snapshot is truncated");
+    }
+}  // readSnapshotElements()
+
+#endif  // SNAPSHOT_H
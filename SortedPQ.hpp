@@ -5,39 +5,52 @@
 
 #include <algorithm>
 #include <iostream>
+#include <numeric>
 
+#include "Allocator.hpp"
 #include "Eecs281PQ.hpp"
+#include "PQStats.hpp"
+#include "Parallel.hpp"
+#include "Snapshot.hpp"
+#include "Stable.hpp"
 
 // A specialized version of the priority queue ADT that is implemented with an
 // underlying sorted array-based container.
 // Note: The most extreme element should be found at the end of the
 // 'data' container, such that traversing the iterators yields the elements in
 // sorted order.
-template<typename TYPE, typename COMP_FUNCTOR = std::less<TYPE>>
-class SortedPQ : public Eecs281PQ<TYPE, COMP_FUNCTOR> {
+template<typename TYPE, typename COMP_FUNCTOR = std::less<TYPE>, typename ALLOCATOR = std::allocator<TYPE>>
+class SortedPQ : public Eecs281PQ<TYPE, COMP_FUNCTOR>, public PQCounters {
     // This is a way to refer to the base class object.
     using BaseClass = Eecs281PQ<TYPE, COMP_FUNCTOR>;
 
 public:
-    // Description: Construct an empty PQ with an optional comparison functor.
+    // Description: Construct an empty PQ with an optional comparison functor
+    //              and allocator.
     // Runtime: O(1)
-    explicit SortedPQ(COMP_FUNCTOR comp = COMP_FUNCTOR())
-        : BaseClass { comp } {
+    explicit SortedPQ(COMP_FUNCTOR comp = COMP_FUNCTOR(), const ALLOCATOR &alloc = ALLOCATOR())
+        : BaseClass { comp }
+        , data(alloc)
+        , sequence(alloc) {
         this->compare = comp; 
         // TODO: Implement this function, or verify that it is already done
     }  // SortedPQ
 
 
     // Description: Construct a PQ out of an iterator range with an optional
-    //              comparison functor.
+    //              comparison functor, and optionally sort it on several
+    //              threads and allocate through alloc.
     // Runtime: O(n log n) where n is number of elements in range.
     template<typename InputIterator>
-    SortedPQ(InputIterator start, InputIterator end, COMP_FUNCTOR comp = COMP_FUNCTOR())
-        : BaseClass { comp } {
+    SortedPQ(InputIterator start, InputIterator end, COMP_FUNCTOR comp = COMP_FUNCTOR(),
+             ParallelOptions parallel = ParallelOptions(), const ALLOCATOR &alloc = ALLOCATOR())
+        : BaseClass { comp }
+        , data(start, end, alloc)
+        , parallelism { parallel }
+        , sequence(alloc) {
         
         this->compare = comp;
-        data = vector<TYPE> (start, end);
-        updatePriorities(data);
+        updatePriorities();
                 // TODO: Implement this function
 
     }  // SortedPQ
@@ -63,7 +76,13 @@ public:
     // Description: Add a new element to the PQ.
     // Runtime: O(n)
     virtual void push(const TYPE &val) {
-        auto it = upper_bound(data.begin(), data.end(), val, this->compare);
+        if (order.enabled()) {
+            push_stable(val);
+            return;
+        }
+        auto it = upper_bound(data.begin(), data.end(), val, this->counted(this->compare));
+        this->countMoves(static_cast<std::uint64_t>(data.end() - it));
+        this->countCopies();
         data.insert(it, val);
         // TODO: Implement this function
      // Delete this line when you implement this function
@@ -80,6 +99,9 @@ public:
         if(!data.empty()){
             data.pop_back();
         }
+        if (!sequence.empty()) {
+            sequence.pop_back();
+        }
 
         // TODO: Implement this function
     }  // pop()
@@ -111,21 +133,261 @@ public:
 
 
     // Description: Assumes that all elements inside the PQ are out of order and
-    //              'rebuilds' the PQ by fixing the PQ invariant.
+    //              'rebuilds' the PQ by fixing the PQ invariant.  Large PQs
+    //              are sorted on several threads if setParallelism() allows
+    //              it, unless the PQ is in stable mode.
     // Runtime: O(n log n)
     virtual void updatePriorities() {
-        sort(data.begin(), data.end(), this->compare);
+        this->countUpdate();
+        if (order.enabled()) {
+            sort_stable();
+            return;
+        }
+        if (parallelism.useThreads(data.size())) {
+            parallel_sort();
+            return;
+        }
+        sort(data.begin(), data.end(), this->counted(this->compare));
         // TODO: Implement this function
     }  // updatePriorities()
 
 
+    // Description: Set how many threads updatePriorities() may use, and the
+    //              PQ size below which it stays serial.
+    void setParallelism(ParallelOptions parallel) { parallelism = parallel; }
+
+
+    // Description: Turn stable mode on or off. In stable mode, elements that
+    //              compare equal are popped in the order they were pushed,
+    //              even after updatePriorities(), at the cost of a 32-bit
+    //              insertion number per element. Elements already in the PQ
+    //              count as pushed in the order they would be popped. The
+    //              live numbers are renumbered once limit elements have been
+    //              numbered; only tests need anything but the default.
+    // Runtime: O(n)
+    void setStable(bool stable, InsertionOrder::Sequence limit = InsertionOrder::kMaxLimit) {
+        order.setLimit(limit);
+        if (stable == order.enabled()) {
+            return;
+        }
+        if (stable) {
+            number_popping_order();
+        } else {
+            sequence.clear();
+            order.enable(false);
+        }
+    }  // setStable()
+
+
+    // Iterators over the underlying sorted data, least extreme element
+    // first.  Traversing [begin(), end()) visits the PQ in priority order
+    // without copying or draining it; the most extreme element is the one
+    // just before end().
+    using const_iterator = typename std::vector<TYPE, ALLOCATOR>::const_iterator;
+
+    // Description: Return an iterator to the least extreme element.
+    // Runtime: O(1)
+    const_iterator begin() const { return data.cbegin(); }
+
+    // Description: Return an iterator one past the most extreme element.
+    // Runtime: O(1)
+    const_iterator end() const { return data.cend(); }
+
+
+    // Description: Return an iterator to the first element that is not less
+    //              extreme than val (as defined by 'compare').  Every element
+    //              in [lower_bound(val), end()) is at least as extreme as val.
+    // Runtime: O(log(n))
+    const_iterator lower_bound(const TYPE &val) const {
+        return std::lower_bound(data.cbegin(), data.cend(), val, this->counted(this->compare));
+    }  // lower_bound()
+
+
+    // Description: Count the elements that are strictly more extreme than val
+    //              (as defined by 'compare').
+    // Runtime: O(log(n))
+    [[nodiscard]] std::size_t count_above(const TYPE &val) const {
+        auto it = std::upper_bound(data.cbegin(), data.cend(), val, this->counted(this->compare));
+        return static_cast<std::size_t>(data.cend() - it);
+    }  // count_above()
+
+
+    // Description: Remove elements from the top of the PQ for as long as
+    //              pred returns true for the current top, using a single
+    //              erase for the whole run.  Returns the number removed.
+    // Runtime: O(k) where k is the number of elements removed.
+    template<typename Predicate>
+    std::size_t pop_while(Predicate pred) {
+        auto first = std::find_if_not(data.rbegin(), data.rend(), pred).base();
+        auto removed = static_cast<std::size_t>(data.end() - first);
+        data.erase(first, data.end());
+        if (!sequence.empty()) {
+            sequence.resize(data.size());
+        }
+        return removed;
+    }  // pop_while()
+
+
+    // Description: Make room for n elements in all, so that pushing up to
+    //              that many does not reallocate.
+    // Runtime: O(n)
+    void reserve(size_t n) {
+        data.reserve(n);
+        if (order.enabled()) {
+            sequence.reserve(n);
+        }
+    }  // reserve()
+
+
+    // Description: Get the number of elements the PQ can hold before it
+    //              reallocates.
+    // Runtime: O(1)
+    [[nodiscard]] size_t capacity() const { return data.capacity(); }
+
+
+    // Description: Return unused capacity to the allocator.
+    // Runtime: O(n)
+    void shrink_to_fit() {
+        data.shrink_to_fit();
+        sequence.shrink_to_fit();
+    }  // shrink_to_fit()
+
+
+    // Description: Get a copy of the allocator the PQ allocates through.
+    // Runtime: O(1)
+    ALLOCATOR get_allocator() const { return data.get_allocator(); }
+
+
+    // Description: Write the PQ to os as a binary snapshot (see Snapshot.hpp).
+    //              TYPE must be trivially copyable.
+    // Runtime: O(n)
+    void save(std::ostream &os) const {
+        writeSnapshotHeader<TYPE>(os, data.size(), SnapshotLayout::Sorted);
+        writeSnapshotElements(os, data.data(), data.size());
+    }  // save()
+
+
+    // Description: Replace the contents of the PQ with a snapshot read from
+    //              is. Snapshots of another layout are sorted after loading.
+    //              In stable mode, equal elements of a sorted snapshot keep
+    //              their popping order, and those of any other layout count
+    //              as pushed in their stored order.
+    // Runtime: O(n) for a sorted snapshot, O(n log(n)) otherwise
+    void load(std::istream &is) {
+        SnapshotHeader header = readSnapshotHeader<TYPE>(is);
+        std::vector<TYPE, ALLOCATOR> loaded(header.count, data.get_allocator());
+        readSnapshotElements(is, loaded.data(), loaded.size());
+        data.swap(loaded);
+        if (order.enabled()) {
+            number_popping_order();
+            if (header.layout != SnapshotLayout::Sorted) {
+                std::reverse(sequence.begin(), sequence.end());
+            }
+        }
+        if (header.layout != SnapshotLayout::Sorted) {
+            SortedPQ::updatePriorities();
+        }
+    }  // load()
+
+
 private:
     // Note: This vector *must* be used for your PQ implementation.
-    std::vector<TYPE> data;
+    std::vector<TYPE, ALLOCATOR> data;
+    ParallelOptions parallelism;
+
+    // Insertion number of the element at the same index of data, in stable
+    // mode only. Equal elements are stored newest first, so the oldest one
+    // is popped first.
+    AllocVector<InsertionOrder::Sequence, ALLOCATOR> sequence;
+    InsertionOrder order;
+
+    // Whether the element at index a belongs before (has lower priority
+    // than) the one at index b, in stable mode.
+    bool lower(size_t a, size_t b) const {
+        const auto &less = this->counted(this->compare);
+        if (less(data[a], data[b])) {
+            return true;
+        }
+        return !less(data[b], data[a]) && InsertionOrder::later(sequence[a], sequence[b]);
+    }
+
+    // Number every element so that they pop in the order they are stored,
+    // and start stable mode.
+    void number_popping_order() {
+        sequence.resize(data.size());
+        for (size_t i = 0; i < data.size(); ++i) {
+            sequence[i] = static_cast<InsertionOrder::Sequence>(data.size() - 1 - i);
+        }
+        order.enable(true, static_cast<InsertionOrder::Sequence>(data.size()));
+    }
+
+    // The newest element goes before every element equal to it.
+    void push_stable(const TYPE &val) {
+        if (order.exhausted()) {
+            std::vector<InsertionOrder::Sequence *> live;
+            for (auto &number : sequence) {
+                live.push_back(&number);
+            }
+            order.renumber(live);
+        }
+        auto it = std::lower_bound(data.begin(), data.end(), val, this->counted(this->compare));
+        auto index = it - data.begin();
+        this->countMoves(static_cast<std::uint64_t>(data.end() - it));
+        this->countCopies();
+        data.insert(it, val);
+        sequence.insert(sequence.begin() + index, order.stamp());
+    }
+
+    // Sort by priority, then by insertion number, moving both vectors in
+    // step.
+    void sort_stable() {
+        std::vector<size_t> permutation(data.size());
+        std::iota(permutation.begin(), permutation.end(), size_t { 0 });
+        std::sort(permutation.begin(), permutation.end(), [this](size_t a, size_t b) { return lower(a, b); });
+
+        decltype(data) sorted_data(data.get_allocator());
+        decltype(sequence) sorted_sequence(sequence.get_allocator());
+        sorted_data.reserve(data.size());
+        sorted_sequence.reserve(data.size());
+        for (size_t index : permutation) {
+            sorted_data.push_back(std::move(data[index]));
+            sorted_sequence.push_back(sequence[index]);
+        }
+        this->countMoves(data.size());
+        data.swap(sorted_data);
+        sequence.swap(sorted_sequence);
+    }
 
     // TODO: Add any additional member functions you require here.
     //       You are NOT allowed to add any new member variables.
 
+    // Sort one block of data per thread, then merge neighbouring blocks in
+    // pairs, with the merges of each round also spread over the threads.
+    void parallel_sort() {
+        const size_t blocks = parallelism.threads;
+        auto bound = [this, blocks](size_t block) {
+            size_t index = data.size() * std::min(block, blocks) / blocks;
+            return data.begin() + static_cast<std::ptrdiff_t>(index);
+        };
+
+        parallelFor(blocks, parallelism.threads, [&](size_t block) {
+            std::sort(bound(block), bound(block + 1), this->counted(this->compare));
+        });
+        for (size_t width = 1; width < blocks; width *= 2) {
+            size_t merges = (blocks + 2 * width - 1) / (2 * width);
+            parallelFor(merges, parallelism.threads, [&](size_t merge) {
+                size_t first = 2 * width * merge;
+                std::inplace_merge(bound(first), bound(first + width), bound(first + 2 * width),
+                                   this->counted(this->compare));
+            });
+        }
+    }  // parallel_sort()
+
 };  // SortedPQ
 
+
+// A SortedPQ that allocates through a std::pmr::memory_resource.
+template<typename TYPE, typename COMP_FUNCTOR = std::less<TYPE>>
+using PmrSortedPQ = SortedPQ<TYPE, COMP_FUNCTOR, std::pmr::polymorphic_allocator<TYPE>>;
+
 #endif  // SORTEDPQ_H
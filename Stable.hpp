@@ -0,0 +1,79 @@
+// Project identifier: 43DE0E0C4C76BFAA6D8C2F5AEAE0518A9C42CF4E
+
+#ifndef STABLE_H
+#define STABLE_H
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+// Insertion numbering for the stable mode of BinaryPQ, PairingPQ and
+// SortedPQ, in which elements that compare equal leave in the order they
+// were pushed. Each element is given a 32-bit sequence number and ties go
+// to the lower one. When the numbers run out, the PQ hands over the
+// numbers of its live elements to be renumbered from zero in the same
+// order, so ties resolve exactly as before and the PQ stays valid.
+class InsertionOrder {
+public:
+    using Sequence = std::uint32_t;
+
+    static constexpr Sequence kMaxLimit = std::numeric_limits<Sequence>::max();
+
+    // Description: Number elements up to (not including) limit before
+    //              renumbering. Only tests need anything but the default.
+    explicit InsertionOrder(Sequence limit = kMaxLimit)
+        : limit { limit } {}
+
+
+    // Description: Change the limit, for a PQ's setStable(). Numbers
+    //              already given out are renumbered as soon as they reach
+    //              it.
+    void setLimit(Sequence new_limit) { limit = new_limit; }
+
+
+    // Description: Return true if the PQ is in stable mode.
+    [[nodiscard]] bool enabled() const { return on; }
+
+
+    // Description: Turn stable mode on or off. The next element pushed is
+    //              numbered first.
+    void enable(bool stable, Sequence first = 0) {
+        on = stable;
+        next = first;
+    }  // enable()
+
+
+    // Description: Return true if the numbers have run out, and the PQ must
+    //              renumber() before its next stamp().
+    [[nodiscard]] bool exhausted() const { return next >= limit; }
+
+
+    // Description: Get the number of the element being pushed.
+    // Runtime: O(1)
+    Sequence stamp() { return next++; }
+
+
+    // Description: Renumber every live element 0, 1, ... in its current
+    //              order, and continue numbering after them.
+    // Runtime: O(n log(n))
+    void renumber(std::vector<Sequence *> &live) {
+        std::sort(live.begin(), live.end(), [](const Sequence *a, const Sequence *b) { return *a < *b; });
+        next = 0;
+        for (Sequence *sequence : live) {
+            *sequence = next++;
+        }
+    }  // renumber()
+
+
+    // Description: Return true if, between two equal elements, the one
+    //              numbered a leaves after the one numbered b.
+    static bool later(Sequence a, Sequence b) { return a > b; }
+
+private:
+    Sequence limit;
+    Sequence next = 0;
+    bool on = false;
+};  // InsertionOrder
+
+#endif  // STABLE_H
@@ -0,0 +1,405 @@
+// Project identifier: 43DE0E0C4C76BFAA6D8C2F5AEAE0518A9C42CF4E
+
+#ifndef TIMINGWHEELPQ_H
+#define TIMINGWHEELPQ_H
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "BinaryPQ.hpp"
+#include "Eecs281PQ.hpp"
+
+// The default deadline of an element: the element itself, as a tick count.
+struct TickDeadline {
+    template<typename T>
+    std::uint64_t operator()(const T &val) const {
+        return static_cast<std::uint64_t>(val);
+    }
+};  // TickDeadline
+
+
+// A priority queue for timers, implemented as a hierarchical timing wheel
+// (Varghese and Lauck). Each element has a deadline in integer ticks, given
+// by DEADLINE_OF, and the element with the earliest deadline is the most
+// extreme. COMP_FUNCTOR must agree with that order; it only decides between
+// elements whose deadlines have both been reached.
+//
+// The wheel has kLevels levels of 64 slots; a slot at level k spans 64^k
+// ticks. A timer goes in the lowest level whose span covers the distance
+// between its deadline and the wheel's cursor, so scheduling and
+// cancelling cost O(1). As the cursor reaches a slot at a higher level, its
+// timers are spread over the levels below it, at most once per level.
+// Deadlines beyond the top level, 64^kLevels ticks out, wait in a BinaryPQ
+// until the cursor gets near them.
+//
+// The cursor only moves when top(), pop() or expire() need the next timer,
+// and then straight to that timer's tick. Timers whose deadline has passed
+// wait in a BinaryPQ ordered by COMP_FUNCTOR until they are popped.
+template<typename TYPE, typename COMP_FUNCTOR = std::greater<TYPE>, typename DEADLINE_OF = TickDeadline>
+class TimingWheelPQ : public Eecs281PQ<TYPE, COMP_FUNCTOR> {
+    // This is a way to refer to the base class object.
+    using BaseClass = Eecs281PQ<TYPE, COMP_FUNCTOR>;
+
+public:
+    static constexpr std::size_t kSlotBits = 6;
+    static constexpr std::size_t kSlots = std::size_t { 1 } << kSlotBits;
+    static constexpr std::size_t kLevels = 4;
+
+    // Refers to a scheduled element, for use with cancel(). Stays valid
+    // until the element is popped or cancelled.
+    struct Handle {
+        std::uint32_t index = kNone;
+        std::uint32_t generation = 0;
+    };
+
+    // Description: Construct an empty wheel with its cursor at tick start,
+    //              and optional comparison and deadline functors.
+    // Runtime: O(1)
+    explicit TimingWheelPQ(COMP_FUNCTOR comp = COMP_FUNCTOR(), DEADLINE_OF deadline = DEADLINE_OF(),
+                           std::uint64_t start = 0)
+        : BaseClass { comp }
+        , deadline_of { deadline }
+        , cursor { start }
+        , due { DueComp { comp } } {
+        heads.fill(kNone);
+    }  // TimingWheelPQ()
+
+
+    // Description: Construct a wheel out of an iterator range with optional
+    //              comparison and deadline functors.
+    // Runtime: O(n) where n is number of elements in range.
+    template<typename InputIterator>
+    TimingWheelPQ(InputIterator start, InputIterator end, COMP_FUNCTOR comp = COMP_FUNCTOR(),
+                  DEADLINE_OF deadline = DEADLINE_OF())
+        : TimingWheelPQ { comp, deadline } {
+        while (start != end) {
+            schedule(*start);
+            ++start;
+        }
+    }  // TimingWheelPQ()
+
+
+    // Description: Destructor, copy and move need no code; every member is
+    //              a container.
+    virtual ~TimingWheelPQ() = default;
+
+    TimingWheelPQ(const TimingWheelPQ &) = default;
+    TimingWheelPQ(TimingWheelPQ &&) noexcept = default;
+    TimingWheelPQ &operator=(const TimingWheelPQ &) = default;
+    TimingWheelPQ &operator=(TimingWheelPQ &&) noexcept = default;
+
+
+    // Description: Assumes that the deadlines of all elements may have
+    //              changed and schedules them all again.
+    // Runtime: O(n log(n)) at worst, O(n) if no deadline is far off or past
+    virtual void updatePriorities() {
+        heads.fill(kNone);
+        occupied.fill(0);
+        due = DueHeap { DueComp { this->compare } };
+        overflow = FarHeap {};
+        for (std::uint32_t index = 0; index < nodes.size(); ++index) {
+            if (nodes[index].place != kFree) {
+                nodes[index].deadline = deadline_of(nodes[index].elt);
+                place(index);
+            }
+        }
+    }  // updatePriorities()
+
+
+    // Description: Add a new element to the wheel.
+    // Runtime: O(1), O(log(n)) if its deadline is past or far off
+    virtual void push(const TYPE &val) { schedule(val); }
+
+
+    // Description: Add a new element to the wheel and return a handle that
+    //              can cancel it.
+    // Runtime: O(1), O(log(n)) if its deadline is past or far off
+    Handle schedule(const TYPE &val) {
+        std::uint32_t index = allocate();
+        Node &node = nodes[index];
+        node.elt = val;
+        node.deadline = deadline_of(val);
+        place(index);
+        ++count;
+        return Handle { index, nodes[index].generation };
+    }  // schedule()
+
+
+    // Description: Remove the element that handle refers to. Returns false
+    //              if it was already popped or cancelled.
+    // Runtime: O(1)
+    bool cancel(Handle handle) {
+        if (handle.index >= nodes.size() || nodes[handle.index].generation != handle.generation
+            || nodes[handle.index].place == kFree) {
+            return false;
+        }
+        // Elements that are past or far off are skipped when they come up.
+        if (nodes[handle.index].place >= 0) {
+            unlink(handle.index);
+        }
+        release(handle.index);
+        --count;
+        return true;
+    }  // cancel()
+
+
+    // Description: Remove the element with the earliest deadline from the
+    //              wheel.
+    // Runtime: Amortized O(kLevels + log(number of elements past their
+    //          deadline))
+    virtual void pop() {
+        settle();
+        if (due.empty()) {
+            return;
+        }
+        release(due.top().index);
+        due.pop();
+        --count;
+    }  // pop()
+
+
+    // Description: Return the element with the earliest deadline. Moves the
+    //              cursor up to its deadline.
+    // Runtime: Amortized O(kLevels)
+    virtual const TYPE &top() const {
+        settle();
+        return due.top().elt;
+    }  // top()
+
+
+    // Description: Get the number of elements in the wheel.
+    // Runtime: O(1)
+    [[nodiscard]] virtual std::size_t size() const { return count; }
+
+
+    // Description: Return true if the wheel is empty.
+    // Runtime: O(1)
+    [[nodiscard]] virtual bool empty() const { return count == 0; }
+
+
+    // Description: Return the deadline of top().
+    // Runtime: Amortized O(kLevels)
+    [[nodiscard]] std::uint64_t nextDeadline() const {
+        settle();
+        return nodes[due.top().index].deadline;
+    }  // nextDeadline()
+
+
+    // Description: Return the tick the cursor has reached: no element left
+    //              in the wheel has a deadline before it, except those
+    //              scheduled with a deadline that had already passed.
+    // Runtime: O(1)
+    [[nodiscard]] std::uint64_t now() const { return cursor; }
+
+
+    // Description: Pop every element whose deadline is at or before time,
+    //              in order, and call visit on each. visit may schedule
+    //              more elements; those due by time are expired as well.
+    //              Returns the number of elements expired.
+    // Runtime: Amortized O(kLevels + log(k)) per element expired
+    template<typename Visitor>
+    std::size_t expire(std::uint64_t time, Visitor visit) {
+        std::size_t expired = 0;
+        while (!empty() && nextDeadline() <= time) {
+            TYPE elt = due.top().elt;
+            pop();
+            visit(elt);
+            ++expired;
+        }
+        return expired;
+    }  // expire()
+
+
+private:
+    static constexpr std::uint32_t kNone = std::numeric_limits<std::uint32_t>::max();
+    static constexpr std::size_t kWheelBits = kSlotBits * kLevels;
+
+    // Where a node is: a slot number (level * kSlots + slot) if it is in
+    // the wheel, or one of these.
+    static constexpr int kFree = -1;
+    static constexpr int kDue = -2;
+    static constexpr int kFar = -3;
+
+    struct Node {
+        TYPE elt {};
+        std::uint64_t deadline = 0;
+        std::uint32_t prev = kNone;  // Neighbours in a slot's list; next
+        std::uint32_t next = kNone;  // also links the free list
+        std::uint32_t generation = 0;
+        int place = kFree;
+    };
+
+    // An element whose deadline has been reached. Cancelling it leaves the
+    // entry behind, with a generation that no longer matches its node.
+    struct Due {
+        TYPE elt {};
+        std::uint32_t index = kNone;
+        std::uint32_t generation = 0;
+    };
+
+    struct DueComp {
+        COMP_FUNCTOR compare;
+        bool operator()(const Due &a, const Due &b) const { return compare(a.elt, b.elt); }
+    };
+
+    // An element too far off for the wheel, cancelled the same way.
+    struct Far {
+        std::uint64_t deadline = 0;
+        std::uint32_t index = kNone;
+        std::uint32_t generation = 0;
+    };
+
+    struct FarComp {
+        bool operator()(const Far &a, const Far &b) const { return a.deadline > b.deadline; }
+    };
+
+    using DueHeap = BinaryPQ<Due, DueComp>;
+    using FarHeap = BinaryPQ<Far, FarComp>;
+
+    DEADLINE_OF deadline_of;
+    std::uint64_t cursor;
+    std::size_t count = 0;
+    std::vector<Node> nodes;
+    std::uint32_t free_list = kNone;
+    std::array<std::uint32_t, kLevels * kSlots> heads {};  // First node of each slot
+    std::array<std::uint64_t, kLevels> occupied {};        // Bit per nonempty slot
+    DueHeap due;
+    FarHeap overflow;
+
+    std::uint32_t allocate() {
+        if (free_list == kNone) {
+            nodes.emplace_back();
+            return static_cast<std::uint32_t>(nodes.size() - 1);
+        }
+        std::uint32_t index = free_list;
+        free_list = nodes[index].next;
+        return index;
+    }
+
+    void release(std::uint32_t index) {
+        Node &node = nodes[index];
+        node.place = kFree;
+        ++node.generation;
+        node.next = free_list;
+        free_list = index;
+    }
+
+    template<typename Entry>
+    bool live(const Entry &entry) const {
+        return nodes[entry.index].generation == entry.generation;
+    }
+
+    // Put a node where its deadline belongs relative to the cursor.
+    void place(std::uint32_t index) {
+        Node &node = nodes[index];
+        std::uint64_t deadline = std::max(node.deadline, cursor);
+        if (deadline == cursor) {
+            node.place = kDue;
+            due.push(Due { node.elt, index, node.generation });
+            return;
+        }
+        for (std::size_t level = 0; level < kLevels; ++level) {
+            std::size_t above = kSlotBits * (level + 1);
+            if ((deadline >> above) == (cursor >> above)) {
+                auto slot = static_cast<std::size_t>(deadline >> (kSlotBits * level)) & (kSlots - 1);
+                link(index, level, slot);
+                return;
+            }
+        }
+        node.place = kFar;
+        overflow.push(Far { deadline, index, node.generation });
+    }
+
+    void link(std::uint32_t index, std::size_t level, std::size_t slot) {
+        std::size_t bucket = level * kSlots + slot;
+        Node &node = nodes[index];
+        node.place = static_cast<int>(bucket);
+        node.prev = kNone;
+        node.next = heads[bucket];
+        if (node.next != kNone) {
+            nodes[node.next].prev = index;
+        }
+        heads[bucket] = index;
+        occupied[level] |= std::uint64_t { 1 } << slot;
+    }
+
+    void unlink(std::uint32_t index) {
+        const Node &node = nodes[index];
+        auto bucket = static_cast<std::size_t>(node.place);
+        if (node.prev != kNone) {
+            nodes[node.prev].next = node.next;
+        } else {
+            heads[bucket] = node.next;
+        }
+        if (node.next != kNone) {
+            nodes[node.next].prev = node.prev;
+        }
+        if (heads[bucket] == kNone) {
+            occupied[bucket / kSlots] &= ~(std::uint64_t { 1 } << (bucket % kSlots));
+        }
+    }
+
+    // Move the cursor to the next nonempty slot and spread its nodes over
+    // the levels below, or to the earliest far-off deadline if the wheel is
+    // empty. Returns false if there is nothing left to move to.
+    bool step() {
+        for (std::size_t level = 0; level < kLevels; ++level) {
+            if (occupied[level] == 0) {
+                continue;
+            }
+            // Every nonempty slot is ahead of the cursor, and the levels
+            // below are empty, so the lowest one holds the next deadline.
+            auto slot = static_cast<std::size_t>(__builtin_ctzll(occupied[level]));
+            std::size_t shift = kSlotBits * level;
+            std::uint64_t span = std::uint64_t { 1 } << (shift + kSlotBits);
+            cursor = (cursor & ~(span - 1)) | (static_cast<std::uint64_t>(slot) << shift);
+
+            std::size_t bucket = level * kSlots + slot;
+            std::uint32_t index = heads[bucket];
+            heads[bucket] = kNone;
+            occupied[level] &= ~(std::uint64_t { 1 } << slot);
+            while (index != kNone) {
+                std::uint32_t next = nodes[index].next;
+                place(index);
+                index = next;
+            }
+            return true;
+        }
+
+        while (!overflow.empty() && !live(overflow.top())) {
+            overflow.pop();
+        }
+        if (overflow.empty()) {
+            return false;
+        }
+        cursor = overflow.top().deadline;
+        while (!overflow.empty() && (overflow.top().deadline >> kWheelBits) == (cursor >> kWheelBits)) {
+            Far far = overflow.top();
+            overflow.pop();
+            if (live(far)) {
+                place(far.index);
+            }
+        }
+        return true;
+    }
+
+    // Make due.top() the earliest live element, moving the cursor forward
+    // as far as needed. The order of the elements is unchanged, so this is
+    // allowed from const member functions.
+    void settle() const {
+        auto *self = const_cast<TimingWheelPQ *>(this);
+        for (;;) {
+            while (!due.empty() && !live(due.top())) {
+                self->due.pop();
+            }
+            if (!due.empty() || !self->step()) {
+                return;
+            }
+        }
+    }
+};  // TimingWheelPQ
+
+#endif  // TIMINGWHEELPQ_H
@@ -0,0 +1,104 @@
+// Project identifier: 43DE0E0C4C76BFAA6D8C2F5AEAE0518A9C42CF4E
+
+#ifndef TOMBSTONES_H
+#define TOMBSTONES_H
+
+#include <cstddef>
+#include <vector>
+
+// Bookkeeping for lazy deletion in the array-based priority queues.
+// Every tracked element owns a small integer handle. Erasing an element
+// only flags its handle as dead; the owning PQ discards dead elements when
+// they reach the top, or all at once when too many have piled up.
+// Handles are recycled once their element has left the container.
+class Tombstones {
+public:
+    using Handle = std::size_t;
+
+    // Description: Get a handle for a newly stored, live element.
+    // Runtime: Amortized O(1)
+    Handle acquire() {
+        if (free_list.empty()) {
+            flags.push_back(false);
+            return flags.size() - 1;
+        }  // if ..empty
+
+        Handle handle = free_list.back();
+        free_list.pop_back();
+        return handle;
+    }  // acquire()
+
+
+    // Description: The element owning handle has left the container, so the
+    //              handle may be given out again.
+    // Runtime: Amortized O(1)
+    void release(Handle handle) {
+        if (flags[handle]) {
+            flags[handle] = false;
+            --dead_count;
+        }  // if ..dead
+
+        free_list.push_back(handle);
+    }  // release()
+
+
+    // Description: Mark handle as dead. Returns false if it already was.
+    // Runtime: O(1)
+    bool kill(Handle handle) {
+        if (flags[handle]) {
+            return false;
+        }  // if ..dead
+
+        flags[handle] = true;
+        ++dead_count;
+        return true;
+    }  // kill()
+
+
+    // Description: Return true if handle has been erased but its element is
+    //              still stored.
+    // Runtime: O(1)
+    [[nodiscard]] bool dead(Handle handle) const { return flags[handle]; }
+
+
+    // Description: Get the number of dead elements still stored.
+    // Runtime: O(1)
+    [[nodiscard]] std::size_t count() const { return dead_count; }
+
+
+    // Description: Get the fraction of 'stored' elements that are dead.
+    // Runtime: O(1)
+    [[nodiscard]] double ratio(std::size_t stored) const {
+        return stored == 0 ? 0.0 : static_cast<double>(dead_count) / static_cast<double>(stored);
+    }  // ratio()
+
+
+    // Description: Forget every handle, keeping the threshold. Used when the
+    //              owner's contents are replaced wholesale.
+    void clear() {
+        flags.clear();
+        free_list.clear();
+        dead_count = 0;
+    }  // clear()
+
+
+    // Description: Set the dead fraction above which the owner compacts.
+    void setThreshold(double fraction) { threshold = fraction; }
+    [[nodiscard]] double getThreshold() const { return threshold; }
+
+
+    // Description: Return true if the owner, currently storing 'stored'
+    //              elements, should discard its dead ones now.
+    // Runtime: O(1)
+    [[nodiscard]] bool shouldCompact(std::size_t stored) const {
+        return dead_count > 0 && ratio(stored) > threshold;
+    }  // shouldCompact()
+
+private:
+    std::vector<bool> flags;
+    std::vector<Handle> free_list;
+    std::size_t dead_count = 0;
+    double threshold = 0.5;  // NOLINT: half the storage may be tombstones
+};  // Tombstones
+
+#endif  // TOMBSTONES_H
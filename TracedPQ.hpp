@@ -0,0 +1,223 @@
+// Project identifier: 43DE0E0C4C76BFAA6D8C2F5AEAE0518A9C42CF4E
+
+#ifndef TRACEDPQ_H
+#define TRACEDPQ_H
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include "LatencyHistogram.hpp"
+
+// The PQ operations a TracedPQ times.
+enum class PQOp {
+    Push,
+    Pop,
+    Top,
+    UpdatePriorities,
+    UpdateElt,
+};
+static const std::size_t kPQOpCount = 5;
+
+
+// Description: Get the name of op, as used in reports and trace events.
+inline const char *pqOpName(PQOp op) {
+    switch (op) {
+    case PQOp::Push:
+        return "push";
+    case PQOp::Pop:
+        return "pop";
+    case PQOp::Top:
+        return "top";
+    case PQOp::UpdatePriorities:
+        return "updatePriorities";
+    case PQOp::UpdateElt:
+        return "updateElt";
+    }
+    return "unknown";
+}  // pqOpName()
+
+
+// Receives one event for every operation a TracedPQ samples.
+class TraceSink {
+public:
+    virtual ~TraceSink() = default;
+
+    // Description: Called after op ran, starting at 'start' and taking 'ns'
+    //              nanoseconds.
+    virtual void event(PQOp op, std::chrono::steady_clock::time_point start, std::uint64_t ns) = 0;
+};  // TraceSink
+
+
+// A TraceSink that writes Chrome trace JSON (the 'traceEvents' format read
+// by chrome://tracing and Perfetto) to a local file. The file is complete
+// once the writer is destroyed.
+class ChromeTraceWriter : public TraceSink {
+public:
+    explicit ChromeTraceWriter(const std::string &path)
+        : out { path } {
+        if (!out) {
+            throw std::runtime_error("ChromeTraceWriter: cannot open " + path);
+        }
+        out << "{\"traceEvents\":[";
+    }  // ChromeTraceWriter()
+
+    ~ChromeTraceWriter() override { out << "\n]}\n"; }
+
+    ChromeTraceWriter(const ChromeTraceWriter &) = delete;
+    ChromeTraceWriter &operator=(const ChromeTraceWriter &) = delete;
+
+    void event(PQOp op, std::chrono::steady_clock::time_point start, std::uint64_t ns) override {
+        // Chrome trace times are in microseconds since the trace began.
+        double ts = std::chrono::duration<double, std::micro>(start - origin).count();
+        out << (first ? "\n" : ",\n") << "{\"name\":\"" << pqOpName(op) << "\",\"ph\":\"X\",\"ts\":" << ts
+            << ",\"dur\":" << static_cast<double>(ns) / 1e3 << ",\"pid\":0,\"tid\":0}";  // NOLINT: ns to us
+        first = false;
+    }  // event()
+
+private:
+    std::ofstream out;
+    std::chrono::steady_clock::time_point origin = std::chrono::steady_clock::now();
+    bool first = true;
+};  // ChromeTraceWriter
+
+
+// Any of the PQs, with the latency of each push(), pop(), top(),
+// updatePriorities() and updateElt() (PairingPQ) recorded in a histogram
+// and optionally sent to a TraceSink. Use it in place of the PQ it wraps,
+// e.g. TracedPQ<PairingPQ<int>>; it takes the same constructor arguments.
+//
+// Reading the clock costs about as much as a fast push(), so by default
+// only one operation in kDefaultSampling is timed, which keeps the
+// overhead in the low single digits (see bench_trace). setSampling(1)
+// times every operation.
+template<typename PQ>
+class TracedPQ : public PQ {
+public:
+    using value_type = std::decay_t<decltype(std::declval<const PQ &>().top())>;
+    static const unsigned kDefaultSampling = 64;  // NOLINT: see bench_trace
+
+    using PQ::PQ;
+
+
+    // Description: Time one in 'every' calls of each operation (1 times all
+    //              of them). Each operation is sampled separately, so a
+    //              regular pattern such as top() then pop() cannot hide one
+    //              of them.
+    void setSampling(unsigned every) {
+        sampling = every > 0 ? every : 1;
+        countdowns.fill(sampling);
+    }  // setSampling()
+
+
+    // Description: Send every timed operation to sink as well, or stop
+    //              sending if sink is nullptr. The sink must outlive this PQ.
+    void setTraceSink(TraceSink *sink) { trace = sink; }
+
+
+    // Description: Get the latencies recorded for op.
+    [[nodiscard]] const LatencyHistogram &histogram(PQOp op) const {
+        return histograms[static_cast<std::size_t>(op)];
+    }  // histogram()
+
+
+    // Description: Print count and p50/p99/p99.9/max latencies per operation.
+    void report(std::ostream &os) const {
+        for (std::size_t op = 0; op < kPQOpCount; ++op) {
+            const LatencyHistogram &h = histograms[op];
+            if (h.count() == 0) {
+                continue;
+            }
+            os << pqOpName(static_cast<PQOp>(op)) << ": " << h.count() << " timed, p50 "
+               << h.percentile(0.5) << " ns, p99 " << h.percentile(0.99) << " ns, p99.9 "  // NOLINT: percentiles
+               << h.percentile(0.999) << " ns, max " << h.max() << " ns\n";               // NOLINT: percentiles
+        }
+    }  // report()
+
+
+    virtual void push(const value_type &val) {
+        Timer timer { this, PQOp::Push };
+        PQ::push(val);
+    }  // push()
+
+    virtual void pop() {
+        Timer timer { this, PQOp::Pop };
+        PQ::pop();
+    }  // pop()
+
+    virtual const value_type &top() const {
+        Timer timer { this, PQOp::Top };
+        return PQ::top();
+    }  // top()
+
+    virtual void updatePriorities() {
+        Timer timer { this, PQOp::UpdatePriorities };
+        PQ::updatePriorities();
+    }  // updatePriorities()
+
+    // Only instantiated, and so only required to exist, if it is called.
+    template<typename Node>
+    void updateElt(Node *node, const value_type &new_value) {
+        Timer timer { this, PQOp::UpdateElt };
+        PQ::updateElt(node, new_value);
+    }  // updateElt()
+
+
+private:
+    unsigned sampling = kDefaultSampling;
+    mutable std::array<unsigned, kPQOpCount> countdowns = filled(kDefaultSampling);
+    TraceSink *trace = nullptr;
+    mutable std::array<LatencyHistogram, kPQOpCount> histograms;
+
+    static std::array<unsigned, kPQOpCount> filled(unsigned value) {
+        std::array<unsigned, kPQOpCount> values {};
+        values.fill(value);
+        return values;
+    }  // filled()
+
+    // Times the enclosing operation if it is sampled, recording it when the
+    // operation returns.
+    class Timer {
+    public:
+        Timer(const TracedPQ *pq, PQOp op)
+            : pq { pq }
+            , op { op } {
+            unsigned &countdown = pq->countdowns[static_cast<std::size_t>(op)];
+            if (--countdown == 0) {
+                countdown = pq->sampling;
+                active = true;
+                start = std::chrono::steady_clock::now();
+            }
+        }  // Timer()
+
+        ~Timer() {
+            if (active) {
+                auto ns = static_cast<std::uint64_t>(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start)
+                        .count());
+                pq->histograms[static_cast<std::size_t>(op)].record(ns);
+                if (pq->trace) {
+                    pq->trace->event(op, start, ns);
+                }
+            }
+        }  // ~Timer()
+
+        Timer(const Timer &) = delete;
+        Timer &operator=(const Timer &) = delete;
+
+    private:
+        const TracedPQ *pq;
+        PQOp op;
+        bool active = false;
+        std::chrono::steady_clock::time_point start;
+    };  // Timer
+};  // TracedPQ
+
+#endif  // TRACEDPQ_H
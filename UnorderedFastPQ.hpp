@@ -5,7 +5,12 @@
 
 #include <limits>  // needed for kUnknown
 
+#include "Allocator.hpp"
 #include "Eecs281PQ.hpp"
+#include "PQStats.hpp"
+#include "Projection.hpp"
+#include "Snapshot.hpp"
+#include "Tombstones.hpp"
 
 static const size_t kUnknown = std::numeric_limits<size_t>::max();
 
@@ -21,27 +26,35 @@ static const size_t kUnknown = std::numeric_limits<size_t>::max();
 // Pay particular attention to how the constructors and findExtreme()
 // are written, especially the use of this->compare.
 
-template<typename TYPE, typename COMP_FUNCTOR = std::less<TYPE>>
-class UnorderedFastPQ : public Eecs281PQ<TYPE, COMP_FUNCTOR> {
+template<typename TYPE, typename COMP_FUNCTOR = std::less<TYPE>, typename ALLOCATOR = std::allocator<TYPE>>
+class UnorderedFastPQ : public Eecs281PQ<TYPE, COMP_FUNCTOR>, public PQCounters {
     // This is a way to refer to the base class object.
     using BaseClass = Eecs281PQ<TYPE, COMP_FUNCTOR>;
 
 public:
-    // Description: Construct an empty PQ with optional comparison functor.
+    // Refers to an element pushed with pushHandle(), for use with erase().
+    using Handle = Tombstones::Handle;
+
+    // Description: Construct an empty PQ with optional comparison functor
+    //              and allocator.
     // Runtime: O(1)
-    explicit UnorderedFastPQ(COMP_FUNCTOR comp = COMP_FUNCTOR())
+    explicit UnorderedFastPQ(COMP_FUNCTOR comp = COMP_FUNCTOR(), const ALLOCATOR &alloc = ALLOCATOR())
         : BaseClass { comp }
-        , extreme { kUnknown } {}  // UnorderedFastPQ()
+        , data(alloc)
+        , extreme { kUnknown }
+        , handles(alloc) {}  // UnorderedFastPQ()
 
 
     // Description: Construct a PQ out of an iterator range with optional
-    //              comparison functor.
+    //              comparison functor and allocator.
     // Runtime: O(n) where n is number of elements in range.
     template<typename InputIterator>
-    UnorderedFastPQ(InputIterator start, InputIterator end, COMP_FUNCTOR comp = COMP_FUNCTOR())
+    UnorderedFastPQ(InputIterator start, InputIterator end, COMP_FUNCTOR comp = COMP_FUNCTOR(),
+                    const ALLOCATOR &alloc = ALLOCATOR())
         : BaseClass { comp }
-        , data { start, end }
-        , extreme { kUnknown } {}
+        , data(start, end, alloc)
+        , extreme { kUnknown }
+        , handles(alloc) {}
 
 
     // Description: Destructor doesn't need any code, the data vector will
@@ -64,13 +77,20 @@ public:
     // Description: The only thing needed is to mark that we no longer know
     //              the most extreme element.
     // Runtime: O(1)
-    virtual void updatePriorities() { extreme = kUnknown; }
+    virtual void updatePriorities() {
+        this->countUpdate();
+        extreme = kUnknown;
+    }  // updatePriorities()
 
 
     // Description: Add a new element to the PQ.
     // Runtime: Amortized O(1)
     virtual void push(const TYPE &val) {
         data.push_back(val);
+        this->countCopies();
+        if (!handles.empty()) {
+            handles.push_back(tombstones.acquire());
+        }  // if ..tracked
 
         // Since a new element has been added, we no longer know where to
         // find the most extreme element.
@@ -78,6 +98,88 @@ public:
     }  // push()
 
 
+    // Description: Add a new element to the PQ and return a handle that can
+    //              later be passed to erase(). The handle stays valid until
+    //              its element leaves the PQ through pop() or erase().
+    // Runtime: Amortized O(1)
+    Handle pushHandle(const TYPE &val) {
+        // Give a handle to every element pushed before tracking started.
+        while (handles.size() < data.size()) {
+            handles.push_back(tombstones.acquire());
+        }  // while ..untracked
+
+        Handle handle = tombstones.acquire();
+        data.push_back(val);
+        this->countCopies();
+        handles.push_back(handle);
+        extreme = kUnknown;
+        return handle;
+    }  // pushHandle()
+
+
+    // Description: Lazily erase the element referred to by handle. It is only
+    //              marked dead and skipped by top() and pop(); dead elements
+    //              are discarded together once their fraction of the stored
+    //              elements passes the compaction threshold.
+    // Runtime: O(1), plus the amortized cost of compaction.
+    void erase(Handle handle) {
+        if (!tombstones.kill(handle)) {
+            return;
+        }  // if ..already dead
+
+        if (extreme != kUnknown && handles[extreme] == handle) {
+            extreme = kUnknown;
+        }  // if ..erased the extreme
+
+        if (tombstones.shouldCompact(data.size())) {
+            compact();
+        }  // if ..too many tombstones
+    }  // erase()
+
+
+    // Description: Discard every dead element.
+    // Runtime: O(n)
+    void compact() {
+        if (handles.empty()) {
+            return;
+        }  // if ..untracked
+
+        size_t live = 0;
+        for (size_t i = 0; i < handles.size(); ++i) {
+            if (tombstones.dead(handles[i])) {
+                tombstones.release(handles[i]);
+                continue;
+            }  // if ..dead
+
+            if (live != i) {
+                data[live] = std::move(data[i]);
+                this->countMoves();
+                handles[live] = handles[i];
+            }  // if ..moved
+            ++live;
+        }  // for ..i
+
+        data.erase(data.begin() + static_cast<std::ptrdiff_t>(live), data.end());
+        handles.resize(live);
+        UnorderedFastPQ::updatePriorities();
+    }  // compact()
+
+
+    // Description: Set the fraction of stored elements that may be dead
+    //              before erase() or pop() compacts the PQ.
+    void setCompactionThreshold(double fraction) { tombstones.setThreshold(fraction); }
+
+
+    // Description: Get the number of erased elements still stored.
+    // Runtime: O(1)
+    [[nodiscard]] std::size_t tombstoneCount() const { return tombstones.count(); }
+
+
+    // Description: Get the fraction of stored elements that are dead.
+    // Runtime: O(1)
+    [[nodiscard]] double tombstoneRatio() const { return tombstones.ratio(data.size()); }
+
+
     // Description: Remove the most extreme (defined by 'compare') element
     //              from the PQ.
     // Note: We will not run tests on your code that would require it to pop
@@ -96,11 +198,21 @@ public:
         // then pop_back().  This is much faster than erasing from the middle
         // of a vector.
         data[extreme] = data.back();
+        this->countCopies();
         data.pop_back();
+        if (!handles.empty()) {
+            tombstones.release(handles[extreme]);
+            handles[extreme] = handles.back();
+            handles.pop_back();
+        }  // if ..tracked
 
         // Since the most extreme element has been removed, we no longer know
         // where to find it.
         extreme = kUnknown;
+
+        if (tombstones.shouldCompact(data.size())) {
+            compact();
+        }  // if ..too many tombstones
     }  // pop()
 
 
@@ -123,36 +235,144 @@ public:
 
     // Description: Get the number of elements in the PQ.
     // Runtime: O(1)
-    virtual std::size_t size() const { return data.size(); }
+    virtual std::size_t size() const { return data.size() - tombstones.count(); }
 
     // Description: Return true if the PQ is empty.
     // Runtime: O(1)
-    virtual bool empty() const { return data.empty(); }
+    virtual bool empty() const { return size() == 0; }
+
+
+    // Description: Make room for n elements in all, so that pushing up to
+    //              that many does not reallocate.
+    // Runtime: O(n)
+    void reserve(size_t n) {
+        data.reserve(n);
+        if (!handles.empty()) {
+            handles.reserve(n);
+        }
+    }  // reserve()
+
+
+    // Description: Get the number of elements the PQ can hold before it
+    //              reallocates.
+    // Runtime: O(1)
+    [[nodiscard]] size_t capacity() const { return data.capacity(); }
+
+
+    // Description: Return unused capacity to the allocator.
+    // Runtime: O(n)
+    void shrink_to_fit() {
+        data.shrink_to_fit();
+        handles.shrink_to_fit();
+    }  // shrink_to_fit()
+
+
+    // Description: Get a copy of the allocator the PQ allocates through.
+    // Runtime: O(1)
+    ALLOCATOR get_allocator() const { return data.get_allocator(); }
+
+
+    // Description: Write the PQ to os as a binary snapshot (see Snapshot.hpp).
+    //              TYPE must be trivially copyable.
+    //              Erased elements are left out.
+    // Runtime: O(n)
+    void save(std::ostream &os) const {
+        if (tombstones.count() == 0) {
+            writeSnapshotHeader<TYPE>(os, data.size(), SnapshotLayout::Unordered);
+            writeSnapshotElements(os, data.data(), data.size());
+            return;
+        }  // if ..no tombstones
+
+        std::vector<TYPE> live;
+        live.reserve(size());
+        for (size_t i = 0; i < data.size(); ++i) {
+            if (!tombstones.dead(handles[i])) {
+                live.push_back(data[i]);
+            }  // if ..live
+        }  // for ..i
+        writeSnapshotHeader<TYPE>(os, live.size(), SnapshotLayout::Unordered);
+        writeSnapshotElements(os, live.data(), live.size());
+    }  // save()
+
+
+    // Description: Replace the contents of the PQ with a snapshot read from
+    //              is. Any layout can be used as-is. Handles from before
+    //              the load are no longer valid.
+    // Runtime: O(n)
+    void load(std::istream &is) {
+        SnapshotHeader header = readSnapshotHeader<TYPE>(is);
+        std::vector<TYPE, ALLOCATOR> loaded(header.count, data.get_allocator());
+        readSnapshotElements(is, loaded.data(), loaded.size());
+        data.swap(loaded);
+        handles.clear();
+        tombstones.clear();
+        extreme = kUnknown;
+    }  // load()
 
 
 private:
     // Note: This vector *must* be used for your PQ implementation.
-    std::vector<TYPE> data;
+    std::vector<TYPE, ALLOCATOR> data;
 
     // A member variable that can be changed by a const member function;
     // stores the index of the most extreme element, or kUnknown.
     mutable size_t extreme;
 
+    // Handle of the element at the same index of data. Stays empty until
+    // the first pushHandle(), so untracked PQs never pay for it.
+    AllocVector<Handle, ALLOCATOR> handles;
+    Tombstones tombstones;
+
     // Description: Find the 'most extreme' element of the data vector, using
     //              this->compare() to check if one element is 'less than'
     //              another.
     // Runtime: O(n)
     void findExtreme() const {
+        if (tombstones.count() > 0) {
+            findLiveExtreme();
+            return;
+        }  // if ..tombstones
+
+        if constexpr (kScanKeys<TYPE, COMP_FUNCTOR>) {
+            this->countCompares(data.size() - 1);
+            extreme = scanKeys(data.data(), data.size(), this->compare);
+            return;
+        }  // if ..kScanKeys
+
         size_t index = 0;
 
         for (size_t i = 1; i < data.size(); ++i) {
-            if (this->compare(data[index], data[i])) {
+            if (this->counted(this->compare)(data[index], data[i])) {
                 index = i;
             }  // if ..compare
         }  // for ..i
 
         extreme = index;
     }  // findExtreme()
+
+
+    // Description: Same as findExtreme(), but skipping dead elements.
+    // Runtime: O(n)
+    void findLiveExtreme() const {
+        size_t index = kUnknown;
+
+        for (size_t i = 0; i < data.size(); ++i) {
+            if (tombstones.dead(handles[i])) {
+                continue;
+            }  // if ..dead
+
+            if (index == kUnknown || this->counted(this->compare)(data[index], data[i])) {
+                index = i;
+            }  // if ..compare
+        }  // for ..i
+
+        extreme = index;
+    }  // findLiveExtreme()
 };  // UnorderedFastPQ
 
+
+// A UnorderedFastPQ that allocates through a std::pmr::memory_resource.
+template<typename TYPE, typename COMP_FUNCTOR = std::less<TYPE>>
+using PmrUnorderedFastPQ = UnorderedFastPQ<TYPE, COMP_FUNCTOR, std::pmr::polymorphic_allocator<TYPE>>;
+
 #endif  // UNORDEREDFASTPQ_H
@@ -4,7 +4,11 @@
 #ifndef UNORDEREDPQ_H
 #define UNORDEREDPQ_H
 
+#include "Allocator.hpp"
 #include "Eecs281PQ.hpp"
+#include "PQStats.hpp"
+#include "Projection.hpp"
+#include "Snapshot.hpp"
 
 // A specialized version of the priority queue ADT that is implemented with
 // an underlying unordered array-based container that is linearly searched
@@ -14,25 +18,28 @@
 // Pay particular attention to how the constructors and findExtreme()
 // are written, especially the use of this->compare.
 
-template<typename TYPE, typename COMP_FUNCTOR = std::less<TYPE>>
-class UnorderedPQ : public Eecs281PQ<TYPE, COMP_FUNCTOR> {
+template<typename TYPE, typename COMP_FUNCTOR = std::less<TYPE>, typename ALLOCATOR = std::allocator<TYPE>>
+class UnorderedPQ : public Eecs281PQ<TYPE, COMP_FUNCTOR>, public PQCounters {
     // This is a way to refer to the base class object.
     using BaseClass = Eecs281PQ<TYPE, COMP_FUNCTOR>;
 
 public:
-    // Description: Construct an empty PQ with optional comparison functor.
+    // Description: Construct an empty PQ with optional comparison functor
+    //              and allocator.
     // Runtime: O(1)
-    explicit UnorderedPQ(COMP_FUNCTOR comp = COMP_FUNCTOR())
-        : BaseClass { comp } {}  // UnorderedPQ()
+    explicit UnorderedPQ(COMP_FUNCTOR comp = COMP_FUNCTOR(), const ALLOCATOR &alloc = ALLOCATOR())
+        : BaseClass { comp }
+        , data(alloc) {}  // UnorderedPQ()
 
 
     // Description: Construct a PQ out of an iterator range with optional
-    //              comparison functor.
+    //              comparison functor and allocator.
     // Runtime: O(n) where n is number of elements in range.
     template<typename InputIterator>
-    UnorderedPQ(InputIterator start, InputIterator end, COMP_FUNCTOR comp = COMP_FUNCTOR())
+    UnorderedPQ(InputIterator start, InputIterator end, COMP_FUNCTOR comp = COMP_FUNCTOR(),
+                const ALLOCATOR &alloc = ALLOCATOR())
         : BaseClass { comp }
-        , data { start, end } {}
+        , data(start, end, alloc) {}
 
 
     // Description: Destructor doesn't need any code, the data vector will
@@ -55,12 +62,15 @@ public:
     // Description: Does nothing for this implementation, as items can never
     //              be 'out of order'.
     // Runtime: O(1)
-    virtual void updatePriorities() {}
+    virtual void updatePriorities() { this->countUpdate(); }
 
 
     // Description: Add a new element to the PQ.
     // Runtime: Amortized O(1)
-    virtual void push(const TYPE &val) { data.push_back(val); }
+    virtual void push(const TYPE &val) {
+        data.push_back(val);
+        this->countCopies();
+    }  // push()
 
 
     // Description: Remove the most extreme (defined by 'compare') element
@@ -76,6 +86,7 @@ public:
         // then pop_back().  This is much faster than erasing from the middle
         // of a vector.
         data[findExtreme()] = data.back();
+        this->countCopies();
         data.pop_back();
     }  // pop()
 
@@ -100,19 +111,70 @@ public:
     // Runtime: O(1)
     [[nodiscard]] virtual bool empty() const { return data.empty(); }
 
+
+    // Description: Make room for n elements in all, so that pushing up to
+    //              that many does not reallocate.
+    // Runtime: O(n)
+    void reserve(size_t n) {
+        data.reserve(n);
+    }  // reserve()
+
+
+    // Description: Get the number of elements the PQ can hold before it
+    //              reallocates.
+    // Runtime: O(1)
+    [[nodiscard]] size_t capacity() const { return data.capacity(); }
+
+
+    // Description: Return unused capacity to the allocator.
+    // Runtime: O(n)
+    void shrink_to_fit() {
+        data.shrink_to_fit();
+    }  // shrink_to_fit()
+
+
+    // Description: Get a copy of the allocator the PQ allocates through.
+    // Runtime: O(1)
+    ALLOCATOR get_allocator() const { return data.get_allocator(); }
+
+
+    // Description: Write the PQ to os as a binary snapshot (see Snapshot.hpp).
+    //              TYPE must be trivially copyable.
+    // Runtime: O(n)
+    void save(std::ostream &os) const {
+        writeSnapshotHeader<TYPE>(os, data.size(), SnapshotLayout::Unordered);
+        writeSnapshotElements(os, data.data(), data.size());
+    }  // save()
+
+
+    // Description: Replace the contents of the PQ with a snapshot read from
+    //              is. Any layout can be used as-is.
+    // Runtime: O(n)
+    void load(std::istream &is) {
+        SnapshotHeader header = readSnapshotHeader<TYPE>(is);
+        std::vector<TYPE, ALLOCATOR> loaded(header.count, data.get_allocator());
+        readSnapshotElements(is, loaded.data(), loaded.size());
+        data.swap(loaded);
+    }  // load()
+
 private:
     // Note: This vector *must* be used for your PQ implementation.
-    std::vector<TYPE> data;
+    std::vector<TYPE, ALLOCATOR> data;
 
     // Description: Find the 'most extreme' element of the data vector, using
     //              this->compare() to check if one element is 'less than'
     //              another.
     // Runtime: O(n)
     [[nodiscard]] size_t findExtreme() const {
+        if constexpr (kScanKeys<TYPE, COMP_FUNCTOR>) {
+            this->countCompares(data.size() - 1);
+            return scanKeys(data.data(), data.size(), this->compare);
+        }  // if ..kScanKeys
+
         size_t index = 0;
 
         for (size_t i = 1; i < data.size(); ++i) {
-            if (this->compare(data[index], data[i])) {
+            if (this->counted(this->compare)(data[index], data[i])) {
                 index = i;
             }  // if ..compare()
         }  // for ..i
@@ -121,4 +183,9 @@ private:
     }  // findExtreme()
 };  // UnorderedPQ
 
+
+// A UnorderedPQ that allocates through a std::pmr::memory_resource.
+template<typename TYPE, typename COMP_FUNCTOR = std::less<TYPE>>
+using PmrUnorderedPQ = UnorderedPQ<TYPE, COMP_FUNCTOR, std::pmr::polymorphic_allocator<TYPE>>;
+
 #endif  // UNORDEREDPQ_H
@@ -0,0 +1,88 @@
+// Project identifier: 43DE0E0C4C76BFAA6D8C2F5AEAE0518A9C42CF4E
+
+// Benchmark for allocator-aware PQs: many short requests, each of which
+// builds a BinaryPQ, fills it and drains it, as a server handling one query
+// at a time would. Compares
+//   - std::allocator (malloc), growing as it goes,
+//   - std::allocator with reserve() up front,
+//   - a std::pmr::monotonic_buffer_resource over one buffer, released
+//     after every request, and
+//   - a std::pmr::unsynchronized_pool_resource shared by all requests.
+//
+// Usage: ./bench_alloc [requests = 200000] [elements per request = 200]
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <memory_resource>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "BinaryPQ.hpp"
+
+namespace {
+
+// Run every request, building its PQ with make(), and report the time per
+// request.
+template<typename Make>
+void benchRequests(const char *name, std::size_t requests, const std::vector<std::uint32_t> &keys,
+                   std::size_t per_request, Make make) {
+    std::uint64_t checksum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t r = 0; r < requests; ++r) {
+        auto pq = make(per_request);
+        for (std::size_t i = 0; i < per_request; ++i) {
+            pq.push(keys[(r + i) % keys.size()]);
+        }
+        while (!pq.empty()) {
+            checksum += pq.top();
+            pq.pop();
+        }
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << name << ": " << seconds * 1e9 / static_cast<double>(requests)  // NOLINT: s to ns
+              << " ns/request (checksum " << checksum << ")" << std::endl;
+}
+
+}  // namespace
+
+
+int main(int argc, char *argv[]) {
+    const std::size_t requests = argc > 1 ? std::stoul(argv[1]) : 200000;  // NOLINT: default count
+    const std::size_t per_request = argc > 2 ? std::stoul(argv[2]) : 200;  // NOLINT: default size
+
+    std::mt19937 rng { 281 };  // NOLINT: fixed seed
+    std::vector<std::uint32_t> keys(1 << 16);  // NOLINT: reused key pool
+    for (auto &key : keys) {
+        key = static_cast<std::uint32_t>(rng());
+    }
+
+    benchRequests("std::allocator", requests, keys, per_request,
+                  [](std::size_t) { return BinaryPQ<std::uint32_t> {}; });
+    benchRequests("std::allocator, reserve()", requests, keys, per_request, [](std::size_t n) {
+        BinaryPQ<std::uint32_t> pq {};
+        pq.reserve(n);
+        return pq;
+    });
+
+    // The arena falls back to the heap if a request outgrows the buffer.
+    std::vector<std::byte> buffer(64 * 1024 + 8 * per_request * sizeof(std::uint32_t));  // NOLINT: ample room
+    std::pmr::monotonic_buffer_resource arena { buffer.data(), buffer.size() };
+    benchRequests("pmr monotonic arena", requests, keys, per_request, [&arena](std::size_t) {
+        arena.release();
+        return PmrBinaryPQ<std::uint32_t> { std::less<std::uint32_t> {}, &arena };
+    });
+    benchRequests("pmr monotonic arena, reserve()", requests, keys, per_request, [&arena](std::size_t n) {
+        arena.release();
+        PmrBinaryPQ<std::uint32_t> pq { std::less<std::uint32_t> {}, &arena };
+        pq.reserve(n);
+        return pq;
+    });
+
+    std::pmr::unsynchronized_pool_resource pool;
+    benchRequests("pmr pool", requests, keys, per_request,
+                  [&pool](std::size_t) { return PmrBinaryPQ<std::uint32_t> { std::less<std::uint32_t> {}, &pool }; });
+    return 0;
+}
@@ -0,0 +1,126 @@
+// Project identifier: 43DE0E0C4C76BFAA6D8C2F5AEAE0518A9C42CF4E
+
+// Benchmark for AsyncPQ: a producer hands jobs to consumers that wait on an
+// empty queue, in batches of a given size. Compares
+//   - consumer coroutines on one thread with an AsyncExecutor, and
+//   - consumer threads parked on a condition variable over a BinaryPQ,
+// reporting the time per job handed over. Built as C++20 (see Makefile).
+//
+// Usage: ./bench_async [jobs = 2000000] [batch = 16] [consumers = 4]
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "AsyncPQ.hpp"
+#include "BinaryPQ.hpp"
+
+namespace {
+
+AsyncTask consume(AsyncPQ<BinaryPQ<std::uint32_t>> &pq, std::uint64_t &checksum) {
+    for (;;) {
+        std::uint32_t job = co_await pq.pop_async();
+        if (job == 0) {
+            co_return;
+        }
+        checksum += job;
+    }
+}
+
+
+double benchCoroutines(std::size_t jobs, std::size_t batch, std::size_t consumers, std::uint64_t &checksum) {
+    auto start = std::chrono::steady_clock::now();
+    AsyncExecutor executor;
+    AsyncPQ<BinaryPQ<std::uint32_t>> pq { &executor };
+    for (std::size_t c = 0; c < consumers; ++c) {
+        consume(pq, checksum);
+    }
+    std::vector<std::uint32_t> jobsBatch;
+    for (std::size_t done = 0; done < jobs; done += batch) {
+        jobsBatch.clear();
+        for (std::size_t i = done; i < std::min(jobs, done + batch); ++i) {
+            jobsBatch.push_back(static_cast<std::uint32_t>(i + 1));
+        }
+        pq.push(jobsBatch.begin(), jobsBatch.end());
+        executor.run();
+    }
+    // Job 0 tells each consumer to stop.
+    const std::vector<std::uint32_t> stops(consumers, 0);
+    pq.push(stops.begin(), stops.end());
+    executor.run();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+
+double benchThreads(std::size_t jobs, std::size_t batch, std::size_t consumers, std::uint64_t &checksum) {
+    auto start = std::chrono::steady_clock::now();
+    std::mutex mutex;
+    std::condition_variable ready;
+    BinaryPQ<std::uint32_t> pq {};
+
+    std::vector<std::thread> threads;
+    for (std::size_t c = 0; c < consumers; ++c) {
+        threads.emplace_back([&] {
+            std::uint64_t sum = 0;
+            for (;;) {
+                std::unique_lock<std::mutex> lock { mutex };
+                ready.wait(lock, [&pq] { return !pq.empty(); });
+                std::uint32_t job = pq.top();
+                pq.pop();
+                if (job == 0) {
+                    break;
+                }
+                lock.unlock();
+                sum += job;
+            }
+            std::lock_guard<std::mutex> lock { mutex };
+            checksum += sum;
+        });
+    }
+    for (std::size_t done = 0; done < jobs; done += batch) {
+        {
+            std::lock_guard<std::mutex> lock { mutex };
+            for (std::size_t i = done; i < std::min(jobs, done + batch); ++i) {
+                pq.push(static_cast<std::uint32_t>(i + 1));
+            }
+        }
+        ready.notify_all();
+    }
+    {
+        std::lock_guard<std::mutex> lock { mutex };
+        for (std::size_t c = 0; c < consumers; ++c) {
+            pq.push(0);
+        }
+    }
+    ready.notify_all();
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+}  // namespace
+
+
+int main(int argc, char *argv[]) {
+    const std::size_t jobs = argc > 1 ? std::stoul(argv[1]) : 2000000;  // NOLINT: default count
+    const std::size_t batch = argc > 2 ? std::stoul(argv[2]) : 16;       // NOLINT: default size
+    const std::size_t consumers = argc > 3 ? std::stoul(argv[3]) : 4;    // NOLINT: default count
+
+    std::uint64_t checksum = 0;
+    double seconds = benchCoroutines(jobs, batch, consumers, checksum);
+    std::cout << "coroutines + executor: " << seconds * 1e9 / static_cast<double>(jobs)  // NOLINT: s to ns
+              << " ns/job (checksum " << checksum << ")" << std::endl;
+
+    checksum = 0;
+    seconds = benchThreads(jobs, batch, consumers, checksum);
+    std::cout << "threads + condition variable: " << seconds * 1e9 / static_cast<double>(jobs)  // NOLINT: s to ns
+              << " ns/job (checksum " << checksum << ")" << std::endl;
+    return 0;
+}
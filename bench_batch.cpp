@@ -0,0 +1,100 @@
+// Project identifier: 43DE0E0C4C76BFAA6D8C2F5AEAE0518A9C42CF4E
+
+// Benchmark for BatchPQ: rounds of popBatch(k) followed by pushBatch() of
+// k new keys, on a queue that holds n keys throughout, for batch sizes
+// from 64 up and 1, 2, 4, ... threads up to the number of hardware
+// threads. Every batch uses threads (min_size = 0), to show what they cost
+// at each size. The baseline is one BinaryPQ behind a mutex, popping and
+// pushing the batch an element at a time.
+//
+// Usage: ./bench_batch [elements = 1048576] [keys moved per run = 4194304] [max threads]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "BatchPQ.hpp"
+#include "BinaryPQ.hpp"
+
+namespace {
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// The keys of the next batch to push, drawn from above what was popped so
+// that the queue drifts upward as an event or task queue does.
+void refill(std::vector<std::uint64_t> &batch, std::uint64_t floor, std::mt19937_64 &rng) {
+    for (auto &key : batch) {
+        key = floor + (rng() >> 8u);  // NOLINT: leave room above the floor
+    }
+}
+
+}  // namespace
+
+
+int main(int argc, char *argv[]) {
+    const std::size_t n = argc > 1 ? std::stoul(argv[1]) : std::size_t { 1 } << 20u;  // NOLINT: default size
+    const std::size_t moved = argc > 2 ? std::stoul(argv[2]) : std::size_t { 1 } << 22u;  // NOLINT: default work
+    unsigned max_threads = argc > 3 ? static_cast<unsigned>(std::stoul(argv[3]))
+                                    : std::max(1u, std::thread::hardware_concurrency());
+
+    std::vector<std::uint64_t> keys(n);
+    std::mt19937_64 rng { 281 };  // NOLINT: fixed seed
+    for (auto &key : keys) {
+        key = rng() >> 8u;  // NOLINT: as refill()
+    }
+    using MinFirst = std::greater<std::uint64_t>;
+
+    std::cout << "Moving " << moved << " 64-bit keys through a queue of " << n << ", in ns per key" << std::endl;
+    for (std::size_t k = 64; k <= std::min<std::size_t>(n, 1u << 18u); k *= 16) {  // NOLINT: 64 to 256K
+        std::size_t rounds = std::max<std::size_t>(1, moved / k);
+        std::vector<std::uint64_t> popped(k);
+        std::vector<std::uint64_t> batch(k);
+        std::cout << "k = " << k << ":";
+
+        {
+            std::mt19937_64 keys_rng { 7 };  // NOLINT: same batches for every run
+            BinaryPQ<std::uint64_t, MinFirst> pq { keys.cbegin(), keys.cend() };
+            std::mutex lock;
+            auto start = std::chrono::steady_clock::now();
+            for (std::size_t round = 0; round < rounds; ++round) {
+                for (auto &key : popped) {
+                    std::lock_guard<std::mutex> guard { lock };
+                    key = pq.top();
+                    pq.pop();
+                }
+                refill(batch, popped.back(), keys_rng);
+                for (auto key : batch) {
+                    std::lock_guard<std::mutex> guard { lock };
+                    pq.push(key);
+                }
+            }
+            std::cout << "  locked BinaryPQ " << secondsSince(start) * 1e9 / double(rounds * k);  // NOLINT: ns
+        }
+
+        for (unsigned threads = 1; threads <= max_threads; threads *= 2) {
+            ParallelOptions parallel;
+            parallel.threads = threads;
+            parallel.min_size = 0;
+
+            std::mt19937_64 keys_rng { 7 };  // NOLINT: same batches for every run
+            BatchPQ<std::uint64_t, MinFirst> pq { keys.cbegin(), keys.cend(), MinFirst {}, parallel };
+            auto start = std::chrono::steady_clock::now();
+            for (std::size_t round = 0; round < rounds; ++round) {
+                pq.popBatch(k, popped.begin());
+                refill(batch, popped.back(), keys_rng);
+                pq.pushBatch(batch.cbegin(), batch.cend());
+            }
+            std::cout << "  " << threads << " thr " << secondsSince(start) * 1e9 / double(rounds * k);  // NOLINT: ns
+        }
+        std::cout << std::endl;
+    }
+    return 0;
+}
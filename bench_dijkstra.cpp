@@ -0,0 +1,377 @@
+// Project identifier: 43DE0E0C4C76BFAA6D8C2F5AEAE0518A9C42CF4E
+
+// Benchmark for the decrease-key heaps: shortest paths (Dijkstra) and
+// minimum spanning trees (Prim) with PairingPQ and HollowPQ raising
+// priorities through updateElt(), and with BinaryPQ pushing duplicates and
+// skipping stale entries. Both searches run on these undirected graphs:
+//   - a random graph with uniformly chosen endpoints,
+//   - a square grid, each vertex joined to its 4 neighbours, and
+//   - a power-law graph grown by preferential attachment, where a few hubs
+//     are joined to a large share of the vertices.
+// Dijkstra also runs on two directed graphs built to stress decrease-key:
+//   - a dense graph, where every relaxation changes a distance: vertices
+//     are settled in order 0, 1, 2, ... and each one shortens the path to
+//     every vertex after it, and
+//   - a fan-out graph, where the source reaches every other vertex by a
+//     long edge and then by a shorter parallel one. This is adversarial for
+//     PairingPQ: the long edges leave every vertex a child of vertex 1, and
+//     updateElt() walks that list of children to unlink each one.
+// Every graph is generated here from a fixed seed. Reports edges scanned
+// per second and the peak memory allocated during each run.
+//
+// Usage: ./bench_dijkstra [random vertices = 1000000] [dense vertices = 3000]
+//                         [fan-out vertices = 20000] [grid side = 1000]
+//                         [power-law vertices = 1000000]
+
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <new>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "BinaryPQ.hpp"
+#include "HollowPQ.hpp"
+#include "PairingPQ.hpp"
+
+namespace {
+
+// Bytes allocated through operator new: now, and the most since the last
+// resetPeak().
+struct Memory {
+    std::size_t allocated = 0;
+    std::size_t peak = 0;
+
+    void resetPeak() { peak = allocated; }
+} memory;
+
+}  // namespace
+
+
+// Every allocation is prefixed with its size so that operator delete can
+// count it back out.
+void *operator new(std::size_t size) {
+    auto *block = static_cast<std::max_align_t *>(std::malloc(size + sizeof(std::max_align_t)));
+    if (block == nullptr) {
+        throw std::bad_alloc();
+    }
+    *reinterpret_cast<std::size_t *>(block) = size;
+    memory.allocated += size;
+    memory.peak = std::max(memory.peak, memory.allocated);
+    return block + 1;
+}
+
+
+void operator delete(void *ptr) noexcept {
+    if (ptr == nullptr) {
+        return;
+    }
+    auto *block = static_cast<std::max_align_t *>(ptr) - 1;
+    memory.allocated -= *reinterpret_cast<std::size_t *>(block);
+    std::free(block);
+}
+
+
+void operator delete(void *ptr, std::size_t /*size*/) noexcept {
+    operator delete(ptr);
+}
+
+
+namespace {
+
+// A graph in compressed sparse row form. An undirected graph has each edge
+// in both directions.
+struct Graph {
+    std::vector<std::size_t> first;  // Edges of v are [first[v], first[v + 1])
+    std::vector<std::uint32_t> target;
+    std::vector<std::uint32_t> weight;
+    bool undirected = false;
+
+    [[nodiscard]] std::size_t vertices() const { return first.size() - 1; }
+};
+
+using Edge = std::tuple<std::uint32_t, std::uint32_t, std::uint32_t>;  // From, to, weight
+
+struct Entry {
+    std::uint64_t key;
+    std::uint32_t vertex;
+};
+
+// Smaller keys have higher priority.
+struct EntryComp {
+    bool operator()(const Entry &a, const Entry &b) const { return a.key > b.key; }
+};
+
+const std::uint64_t kUnreached = std::numeric_limits<std::uint64_t>::max();
+
+
+Graph undirectedGraph(std::size_t n, const std::vector<Edge> &edges) {
+    Graph graph;
+    graph.undirected = true;
+    graph.first.assign(n + 1, 0);
+    for (const auto &[from, to, weight] : edges) {
+        ++graph.first[from + 1];
+        ++graph.first[to + 1];
+    }
+    for (std::size_t v = 0; v < n; ++v) {
+        graph.first[v + 1] += graph.first[v];
+    }
+    graph.target.resize(2 * edges.size());
+    graph.weight.resize(2 * edges.size());
+    std::vector<std::size_t> next { graph.first.begin(), graph.first.end() - 1 };
+    for (const auto &[from, to, weight] : edges) {
+        for (auto [a, b] : { std::pair { from, to }, std::pair { to, from } }) {
+            graph.target[next[a]] = b;
+            graph.weight[next[a]++] = weight;
+        }
+    }
+    return graph;
+}
+
+
+std::uint32_t randomWeight(std::mt19937 &rng) {
+    return static_cast<std::uint32_t>(rng() % 1000 + 1);  // NOLINT: weights 1-1000
+}
+
+
+Graph randomGraph(std::size_t n, std::size_t degree) {
+    std::mt19937 rng { 281 };  // NOLINT: fixed seed
+    std::vector<Edge> edges;
+    for (std::size_t e = 0; e < n * degree / 2; ++e) {
+        edges.emplace_back(rng() % n, rng() % n, randomWeight(rng));
+    }
+    return undirectedGraph(n, edges);
+}
+
+
+Graph gridGraph(std::size_t side) {
+    std::mt19937 rng { 281 };  // NOLINT: fixed seed
+    std::vector<Edge> edges;
+    for (std::size_t row = 0; row < side; ++row) {
+        for (std::size_t col = 0; col < side; ++col) {
+            auto v = static_cast<std::uint32_t>(row * side + col);
+            if (col + 1 < side) {
+                edges.emplace_back(v, v + 1, randomWeight(rng));
+            }
+            if (row + 1 < side) {
+                edges.emplace_back(v, v + side, randomWeight(rng));
+            }
+        }
+    }
+    return undirectedGraph(side * side, edges);
+}
+
+
+// Barabasi-Albert: each new vertex joins 'degree' earlier ones, picked with
+// probability proportional to their degree by drawing from the list of
+// every edge endpoint so far.
+Graph powerLawGraph(std::size_t n, std::size_t degree) {
+    std::mt19937 rng { 281 };  // NOLINT: fixed seed
+    std::vector<Edge> edges;
+    std::vector<std::uint32_t> endpoints;
+    for (std::uint32_t v = 1; v <= degree && v < n; ++v) {  // Start from a star
+        edges.emplace_back(0, v, randomWeight(rng));
+        endpoints.insert(endpoints.end(), { 0, v });
+    }
+    for (auto v = static_cast<std::uint32_t>(degree + 1); v < n; ++v) {
+        for (std::size_t e = 0; e < degree; ++e) {
+            std::uint32_t to = endpoints[rng() % endpoints.size()];
+            edges.emplace_back(v, to, randomWeight(rng));
+            endpoints.insert(endpoints.end(), { v, to });
+        }
+    }
+    return undirectedGraph(n, edges);
+}
+
+
+// Edge i -> j for every i < j, weighted so that the path through i reaches
+// j at distance j + n * (j - i - 1): each newly settled vertex improves
+// every later one, and the shortest distance to j is j.
+Graph denseGraph(std::size_t n) {
+    Graph graph;
+    for (std::size_t i = 0; i < n; ++i) {
+        graph.first.push_back(graph.target.size());
+        for (std::size_t j = n; j-- > i + 1;) {
+            graph.target.push_back(static_cast<std::uint32_t>(j));
+            graph.weight.push_back(static_cast<std::uint32_t>((j - i) + n * (j - i - 1)));
+        }
+    }
+    graph.first.push_back(graph.target.size());
+    return graph;
+}
+
+
+// Edges 0 -> v of weight 2n + v, then again of weight n + v, for every
+// other v.
+Graph fanOutGraph(std::size_t n) {
+    Graph graph;
+    graph.first.push_back(0);
+    for (auto base : { 2 * n, n }) {
+        for (std::size_t v = 1; v < n; ++v) {
+            graph.target.push_back(static_cast<std::uint32_t>(v));
+            graph.weight.push_back(static_cast<std::uint32_t>(base + v));
+        }
+    }
+    for (std::size_t v = 1; v <= n; ++v) {
+        graph.first.push_back(graph.target.size());
+    }
+    return graph;
+}
+
+
+// Dijkstra keys a vertex by its distance from vertex 0, Prim by the
+// lightest edge joining it to the tree grown from vertex 0.
+enum class Search { Dijkstra, Prim };
+
+std::uint64_t candidateKey(Search search, std::uint64_t key, std::uint32_t weight) {
+    return search == Search::Dijkstra ? key + weight : weight;
+}
+
+
+struct Result {
+    double seconds = 0;
+    std::size_t peak_bytes = 0;
+    std::uint64_t checksum = 0;  // Sum of the final keys: distances, or the tree's weight
+    std::uint64_t edges = 0;     // Edges scanned
+    std::uint64_t decreases = 0;
+};
+
+
+// Time search(), and note the most memory it had allocated at once.
+template<typename Search>
+Result measure(Search search) {
+    memory.resetPeak();
+    std::size_t baseline = memory.allocated;
+    auto start = std::chrono::steady_clock::now();
+    Result result = search();
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    result.peak_bytes = memory.peak - baseline;
+    return result;
+}
+
+
+// Search with a heap that raises priorities through updateElt().
+template<template<typename...> typename PQ>
+Result searchHandles(const Graph &graph, Search search) {
+    using Heap = PQ<Entry, EntryComp>;
+    return measure([&graph, search] {
+        Result result;
+        std::vector<std::uint64_t> key(graph.vertices(), kUnreached);
+        std::vector<bool> settled(graph.vertices(), false);
+        std::vector<typename Heap::Node *> nodes(graph.vertices(), nullptr);
+        Heap heap {};
+
+        key[0] = 0;
+        nodes[0] = heap.addNode({ 0, 0 });
+        while (!heap.empty()) {
+            Entry entry = heap.top();
+            heap.pop();
+            nodes[entry.vertex] = nullptr;
+            settled[entry.vertex] = true;
+            result.checksum += entry.key;
+            for (std::size_t e = graph.first[entry.vertex]; e < graph.first[entry.vertex + 1]; ++e) {
+                ++result.edges;
+                std::uint32_t target = graph.target[e];
+                std::uint64_t candidate = candidateKey(search, entry.key, graph.weight[e]);
+                if (settled[target] || candidate >= key[target]) {
+                    continue;
+                }
+                if (nodes[target]) {
+                    heap.updateElt(nodes[target], { candidate, target });
+                    ++result.decreases;
+                } else {
+                    nodes[target] = heap.addNode({ candidate, target });
+                }
+                key[target] = candidate;
+            }
+        }
+        return result;
+    });
+}
+
+
+// Search with a heap that is pushed a new entry for every improvement;
+// entries for vertices already settled are skipped when popped.
+Result searchLazy(const Graph &graph, Search search) {
+    return measure([&graph, search] {
+        Result result;
+        std::vector<std::uint64_t> key(graph.vertices(), kUnreached);
+        std::vector<bool> settled(graph.vertices(), false);
+        BinaryPQ<Entry, EntryComp> heap {};
+
+        key[0] = 0;
+        heap.push({ 0, 0 });
+        while (!heap.empty()) {
+            Entry entry = heap.top();
+            heap.pop();
+            if (settled[entry.vertex]) {
+                continue;
+            }
+            settled[entry.vertex] = true;
+            result.checksum += entry.key;
+            for (std::size_t e = graph.first[entry.vertex]; e < graph.first[entry.vertex + 1]; ++e) {
+                ++result.edges;
+                std::uint32_t target = graph.target[e];
+                std::uint64_t candidate = candidateKey(search, entry.key, graph.weight[e]);
+                if (!settled[target] && candidate < key[target]) {
+                    result.decreases += key[target] != kUnreached;
+                    key[target] = candidate;
+                    heap.push({ candidate, target });
+                }
+            }
+        }
+        return result;
+    });
+}
+
+
+void report(const char *name, const Result &result) {
+    std::cout << "    " << name << ": " << result.seconds << " s, "
+              << static_cast<double>(result.edges) / result.seconds / 1e6 << " M edges/s, "  // NOLINT: millions
+              << static_cast<double>(result.peak_bytes) / (1 << 20) << " MiB peak, "         // NOLINT: MiB
+              << result.decreases << " decrease-keys (checksum " << result.checksum << ")" << std::endl;
+}
+
+
+void benchGraph(const char *name, const Graph &graph) {
+    std::cout << name << " graph, " << graph.vertices() << " vertices, " << graph.target.size() << " edges"
+              << std::endl;
+    for (auto search : { Search::Dijkstra, Search::Prim }) {
+        if (search == Search::Prim && !graph.undirected) {
+            continue;
+        }
+        std::cout << "  " << (search == Search::Dijkstra ? "Dijkstra" : "Prim") << std::endl;
+        report("Pairing", searchHandles<PairingPQ>(graph, search));
+        report("Hollow", searchHandles<HollowPQ>(graph, search));
+        report("Binary, lazy", searchLazy(graph, search));
+    }
+}
+
+}  // namespace
+
+
+int main(int argc, char *argv[]) {
+    const std::size_t random_n = argc > 1 ? std::stoul(argv[1]) : 1000000;      // NOLINT: default size
+    const std::size_t dense_n = argc > 2 ? std::stoul(argv[2]) : 3000;          // NOLINT: default size
+    const std::size_t fan_out_n = argc > 3 ? std::stoul(argv[3]) : 20000;       // NOLINT: default size
+    const std::size_t grid_side = argc > 4 ? std::stoul(argv[4]) : 1000;        // NOLINT: default size
+    const std::size_t power_law_n = argc > 5 ? std::stoul(argv[5]) : 1000000;   // NOLINT: default size
+
+    benchGraph("Random", randomGraph(random_n, 8));  // NOLINT: average degree
+    benchGraph("Grid", gridGraph(grid_side));
+    benchGraph("Power-law", powerLawGraph(power_law_n, 4));  // NOLINT: edges per new vertex
+    benchGraph("Dense", denseGraph(dense_n));
+    benchGraph("Fan-out", fanOutGraph(fan_out_n));
+
+    rusage usage {};
+    getrusage(RUSAGE_SELF, &usage);
+    std::cout << "Process peak RSS: " << usage.ru_maxrss / 1024 << " MiB" << std::endl;  // NOLINT: KiB to MiB
+    return 0;
+}
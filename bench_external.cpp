@@ -0,0 +1,75 @@
+// Project identifier: 43DE0E0C4C76BFAA6D8C2F5AEAE0518A9C42CF4E
+
+// Benchmark for ExternalPQ on a data set several times larger than its
+// in-memory budget, spilling to a local directory.
+//
+// Usage: ./bench_external [budget MiB = 16] [times budget = 10] [dir = .]
+//
+// The budget plays the role of RAM: with the defaults, 160 MiB of 64-bit
+// keys are pushed through a PQ allowed to hold 16 MiB in memory. To check
+// the real 10x RAM case, pass the machine's memory size as the budget.
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+
+#include "ExternalPQ.hpp"
+
+namespace {
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+}  // namespace
+
+
+int main(int argc, char *argv[]) {
+    const std::size_t budget_mib = argc > 1 ? std::stoul(argv[1]) : 16;  // NOLINT: default budget
+    const std::size_t times = argc > 2 ? std::stoul(argv[2]) : 10;       // NOLINT: default multiple
+    const std::string dir = argc > 3 ? argv[3] : ".";
+
+    ExternalPQOptions options;
+    options.dir = dir;
+    options.buffer_bytes = budget_mib << 19u;  // NOLINT: half the budget for the buffer
+    options.max_runs = 64;                     // NOLINT: the rest for run blocks
+    options.block_bytes = (budget_mib << 19u) / options.max_runs;
+
+    const std::size_t n = (budget_mib << 20u) * times / sizeof(std::uint64_t);
+    const double mib = static_cast<double>(n * sizeof(std::uint64_t)) / (1u << 20u);
+    std::cout << "ExternalPQ: " << n << " keys (" << mib << " MiB), budget " << budget_mib
+              << " MiB, runs in " << dir << std::endl;
+
+    ExternalPQ<std::uint64_t> pq { std::less<std::uint64_t> {}, options };
+    std::mt19937_64 rng { 281 };  // NOLINT: fixed seed
+
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < n; ++i) {
+        pq.push(rng());
+    }
+    double push_s = secondsSince(start);
+    std::cout << "push: " << push_s << " s, " << static_cast<double>(n) / push_s / 1e6 << " M/s, "
+              << mib / push_s << " MiB/s, " << pq.runCount() << " runs, each element written "
+              << static_cast<double>(pq.runWrites()) / static_cast<double>(n) << " times" << std::endl;
+
+    start = std::chrono::steady_clock::now();
+    std::uint64_t prev = pq.top();
+    bool ordered = true;
+    while (!pq.empty()) {
+        ordered = ordered && pq.top() <= prev;
+        prev = pq.top();
+        pq.pop();
+    }
+    double pop_s = secondsSince(start);
+    std::cout << "pop:  " << pop_s << " s, " << static_cast<double>(n) / pop_s / 1e6 << " M/s, "
+              << mib / pop_s << " MiB/s" << std::endl;
+
+    if (!ordered) {
+        std::cerr << "ExternalPQ popped out of order!" << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,107 @@
+// Project identifier: 43DE0E0C4C76BFAA6D8C2F5AEAE0518A9C42CF4E
+
+// Benchmark for huge page storage: pop() latency of a large BinaryPQ of
+// 64-bit keys whose heap array comes from the default allocator, and from
+// a HugePageResource with normal pages, transparent huge pages, explicit
+// huge pages, and transparent huge pages interleaved over the NUMA nodes.
+// A heap much larger than the TLB's reach takes a TLB miss at nearly every
+// level of fix_down(), which huge pages mostly remove. AnonHugePages is
+// how much of the process the kernel actually backed with transparent huge
+// pages.
+//
+// Usage: ./bench_hugepages [elements = 33554432] [pops = 1048576]
+
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "BinaryPQ.hpp"
+#include "HugePages.hpp"
+#include "LatencyHistogram.hpp"
+
+namespace {
+
+// The AnonHugePages line of /proc/self/smaps_rollup, in KiB.
+std::uint64_t anonHugePagesKiB() {
+    std::ifstream rollup { "/proc/self/smaps_rollup" };
+    std::string field;
+    std::uint64_t kib = 0;
+    while (rollup >> field) {
+        if (field == "AnonHugePages:") {
+            rollup >> kib;
+            return kib;
+        }
+    }
+    return 0;
+}
+
+template<typename PQ>
+void popLatency(const std::string &name, PQ &pq, std::size_t pops, const HugePageResource *pages) {
+    std::uint64_t huge_kib = anonHugePagesKiB();
+    LatencyHistogram latency;
+    std::uint64_t total_ns = 0;
+    std::uint64_t checksum = 0;
+    for (std::size_t i = 0; i < pops && !pq.empty(); ++i) {
+        auto start = std::chrono::steady_clock::now();
+        checksum += pq.top();
+        pq.pop();
+        auto ns = static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+        latency.record(ns);
+        total_ns += ns;
+    }
+    std::cout << name << ": mean " << double(total_ns) / double(latency.count()) << " ns, p50 "
+              << latency.percentile(0.5) << ", p99 " << latency.percentile(0.99)  // NOLINT: percentiles
+              << ", p99.9 " << latency.percentile(0.999) << " ns; AnonHugePages " << huge_kib / 1024  // NOLINT
+              << " MiB";
+    if (pages != nullptr) {
+        std::cout << "; " << pages->fallbacks() << " fallbacks, " << pages->placementFailures()
+                  << " placement failures";
+    }
+    std::cout << " (checksum " << checksum % 1000 << ")" << std::endl;  // NOLINT: keep the pops live
+}
+
+void runResource(const std::string &name, HugePageOptions options, const std::vector<std::uint64_t> &keys,
+                 std::size_t pops) {
+    HugePageResource pages { options };
+    PmrBinaryPQ<std::uint64_t> pq { keys.cbegin(), keys.cend(), std::less<std::uint64_t> {}, ParallelOptions {},
+                                    &pages };
+    popLatency(name, pq, pops, &pages);
+}
+
+}  // namespace
+
+
+int main(int argc, char *argv[]) {
+    const std::size_t n = argc > 1 ? std::stoul(argv[1]) : std::size_t { 1 } << 25u;  // NOLINT: 256 MiB of keys
+    const std::size_t pops = argc > 2 ? std::stoul(argv[2]) : std::size_t { 1 } << 20u;  // NOLINT: default pops
+
+    std::vector<std::uint64_t> keys(n);
+    std::mt19937_64 rng { 281 };  // NOLINT: fixed seed
+    for (auto &key : keys) {
+        key = rng();
+    }
+    std::cout << "Popping " << pops << " of " << n << " 64-bit keys" << std::endl;
+
+    {
+        BinaryPQ<std::uint64_t> pq { keys.cbegin(), keys.cend() };
+        popLatency("std::allocator          ", pq, pops, nullptr);
+    }
+
+    HugePageOptions options;
+    options.pages = HugePages::None;
+    runResource("normal pages            ", options, keys, pops);
+    options.pages = HugePages::Transparent;
+    runResource("transparent             ", options, keys, pops);
+    options.pages = HugePages::Explicit;
+    runResource("explicit                ", options, keys, pops);
+    options.pages = HugePages::Transparent;
+    options.numa = NumaPlacement::Interleave;
+    runResource("transparent, interleaved", options, keys, pops);
+    return 0;
+}
@@ -0,0 +1,123 @@
+// Project identifier: 43DE0E0C4C76BFAA6D8C2F5AEAE0518A9C42CF4E
+
+// Benchmark for k-way merging: merges the same elements split into k sorted
+// runs, for k = 2, 4, ..., 4096, with
+//   - a BinaryPQ of (value, run) pairs, popping and pushing each step,
+//   - HeapMerge, which uses BinaryPQ::replaceTop() instead, and
+//   - LoserTreeMerge.
+// Reports the time per element merged.
+//
+// Usage: ./bench_merge [elements = 4000000] [max k = 4096]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "BinaryPQ.hpp"
+#include "KWayMerge.hpp"
+
+namespace {
+
+using Runs = std::vector<MergeRun<std::vector<std::uint64_t>::const_iterator>>;
+
+struct Head {
+    std::uint64_t value;
+    std::size_t run;
+};
+
+// Smaller values have higher priority, then earlier runs. Written exactly
+// like HeapMerge's comparator, two calls to std::less on a tie, so the two
+// heap merges differ only in pop+push versus replaceTop().
+struct HeadComp {
+    std::less<std::uint64_t> compare;
+    bool operator()(const Head &a, const Head &b) const {
+        if (compare(b.value, a.value)) {
+            return true;
+        }
+        return !compare(a.value, b.value) && b.run < a.run;
+    }
+};
+
+
+// The merge as it is often written: pop the smallest head, then push the
+// next element of its run.
+void popPushMerge(Runs runs, std::vector<std::uint64_t> &out) {
+    BinaryPQ<Head, HeadComp> heads {};
+    for (std::size_t run = 0; run < runs.size(); ++run) {
+        if (runs[run].first != runs[run].second) {
+            heads.push({ *runs[run].first, run });
+        }
+    }
+    while (!heads.empty()) {
+        Head head = heads.top();
+        heads.pop();
+        out.push_back(head.value);
+        if (++runs[head.run].first != runs[head.run].second) {
+            heads.push({ *runs[head.run].first, head.run });
+        }
+    }
+}
+
+
+template<typename Merge>
+double time(Merge merge, const std::vector<std::uint64_t> &expected) {
+    std::vector<std::uint64_t> out;
+    out.reserve(expected.size());
+    auto start = std::chrono::steady_clock::now();
+    merge(out);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (out != expected) {
+        std::cerr << "merge output is wrong" << std::endl;
+        std::exit(1);
+    }
+    return seconds * 1e9 / static_cast<double>(expected.size());  // NOLINT: s to ns
+}
+
+}  // namespace
+
+
+int main(int argc, char *argv[]) {
+    const std::size_t n = argc > 1 ? std::stoul(argv[1]) : 4000000;      // NOLINT: default size
+    const std::size_t max_k = argc > 2 ? std::stoul(argv[2]) : 4096;     // NOLINT: default fan-in
+
+    std::mt19937_64 rng { 281 };  // NOLINT: fixed seed
+    std::vector<std::uint64_t> values(n);
+    for (auto &value : values) {
+        value = rng();
+    }
+    std::vector<std::uint64_t> expected { values };
+    std::sort(expected.begin(), expected.end());
+
+    std::cout << "k, ns/element: pop+push, replaceTop, loser tree" << std::endl;
+    for (std::size_t k = 2; k <= max_k; k *= 2) {
+        // Deal the values out into k runs and sort each one.
+        std::vector<std::vector<std::uint64_t>> runs(k);
+        for (std::size_t i = 0; i < n; ++i) {
+            runs[i % k].push_back(values[i]);
+        }
+        Runs ranges;
+        for (auto &run : runs) {
+            std::sort(run.begin(), run.end());
+            ranges.emplace_back(run.cbegin(), run.cend());
+        }
+
+        double pop_push = time([&ranges](std::vector<std::uint64_t> &out) { popPushMerge(ranges, out); }, expected);
+        double replace = time(
+            [&ranges](std::vector<std::uint64_t> &out) {
+                kWayMerge(ranges, std::back_inserter(out), std::less<std::uint64_t> {}, MergeStrategy::Heap);
+            },
+            expected);
+        double loser = time(
+            [&ranges](std::vector<std::uint64_t> &out) {
+                kWayMerge(ranges, std::back_inserter(out), std::less<std::uint64_t> {}, MergeStrategy::LoserTree);
+            },
+            expected);
+        std::cout << k << ", " << pop_push << ", " << replace << ", " << loser << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,57 @@
+// Project identifier: 43DE0E0C4C76BFAA6D8C2F5AEAE0518A9C42CF4E
+
+// Benchmark for parallel rebuilds: the BinaryPQ and SortedPQ range
+// constructors, which heapify and sort through updatePriorities(), for
+// 1, 2, 4, ... threads up to the number of hardware threads.
+//
+// Usage: ./bench_parallel [elements = 16777216] [max threads]
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "BinaryPQ.hpp"
+#include "SortedPQ.hpp"
+
+namespace {
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+}  // namespace
+
+
+int main(int argc, char *argv[]) {
+    const std::size_t n = argc > 1 ? std::stoul(argv[1]) : std::size_t { 1 } << 24u;  // NOLINT: default size
+    unsigned max_threads = argc > 2 ? static_cast<unsigned>(std::stoul(argv[2]))
+                                    : std::max(1u, std::thread::hardware_concurrency());
+
+    std::vector<std::uint64_t> keys(n);
+    std::mt19937_64 rng { 281 };  // NOLINT: fixed seed
+    for (auto &key : keys) {
+        key = rng();
+    }
+
+    std::cout << "Rebuilding " << n << " 64-bit keys" << std::endl;
+    for (unsigned threads = 1; threads <= max_threads; threads *= 2) {
+        ParallelOptions parallel;
+        parallel.threads = threads;
+
+        auto start = std::chrono::steady_clock::now();
+        BinaryPQ<std::uint64_t> binary { keys.cbegin(), keys.cend(), std::less<std::uint64_t> {}, parallel };
+        double heapify_s = secondsSince(start);
+
+        start = std::chrono::steady_clock::now();
+        SortedPQ<std::uint64_t> sorted { keys.cbegin(), keys.cend(), std::less<std::uint64_t> {}, parallel };
+        double sort_s = secondsSince(start);
+
+        std::cout << threads << " threads: BinaryPQ heapify " << heapify_s << " s, SortedPQ sort "
+                  << sort_s << " s" << (binary.top() == sorted.top() ? "" : " (MISMATCH)") << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,67 @@
+// Project identifier: 43DE0E0C4C76BFAA6D8C2F5AEAE0518A9C42CF4E
+
+// Benchmark for PersistentPQ: the branching step of a branch-and-bound
+// search. Each branch copies the queue of open nodes, explores it for a
+// few pops and pushes, and throws the copy away, leaving the original for
+// the next branch. Compares PersistentPQ, whose copies share every node,
+// with copying a BinaryPQ or a PairingPQ, for queues of 1000, 10000, ...
+// elements up to the given size. Reports the time per branch.
+//
+// Usage: ./bench_persistent [max queue size = 1000000] [branches = 200]
+//                           [steps per branch = 16]
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "BinaryPQ.hpp"
+#include "PairingPQ.hpp"
+#include "PersistentPQ.hpp"
+
+namespace {
+
+template<typename PQ>
+void branch(const char *name, const std::vector<std::uint64_t> &open, std::size_t branches, std::size_t steps) {
+    const PQ original { open.begin(), open.end() };
+    std::mt19937_64 rng { 281 };  // NOLINT: fixed seed
+    std::uint64_t checksum = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t b = 0; b < branches; ++b) {
+        PQ explored { original };
+        for (std::size_t step = 0; step < steps; ++step) {
+            std::uint64_t bound = explored.top();
+            explored.pop();
+            explored.push(bound - rng() % 1000);  // NOLINT: a child's looser bound
+            checksum += explored.top();
+        }
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "  " << name << ": " << seconds * 1e6 / static_cast<double>(branches)  // NOLINT: s to us
+              << " us/branch (checksum " << checksum << ")" << std::endl;
+}
+
+}  // namespace
+
+
+int main(int argc, char *argv[]) {
+    const std::size_t max_size = argc > 1 ? std::stoul(argv[1]) : 1000000;  // NOLINT: default size
+    const std::size_t branches = argc > 2 ? std::stoul(argv[2]) : 200;      // NOLINT: default count
+    const std::size_t steps = argc > 3 ? std::stoul(argv[3]) : 16;          // NOLINT: default count
+
+    std::mt19937_64 rng { 281 };  // NOLINT: fixed seed
+    for (std::size_t size = 1000; size <= max_size; size *= 10) {  // NOLINT: sizes
+        std::vector<std::uint64_t> open(size);
+        for (auto &bound : open) {
+            bound = rng() >> 1u;
+        }
+        std::cout << size << " open nodes" << std::endl;
+        branch<BinaryPQ<std::uint64_t>>("Binary, copied", open, branches, steps);
+        branch<PairingPQ<std::uint64_t>>("Pairing, copied", open, branches, steps);
+        branch<PersistentPQ<std::uint64_t>>("Persistent, shared", open, branches, steps);
+    }
+    return 0;
+}
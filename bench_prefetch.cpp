@@ -0,0 +1,135 @@
+// Project identifier: 43DE0E0C4C76BFAA6D8C2F5AEAE0518A9C42CF4E
+
+// Benchmark for BinaryPQ's prefetching fix_down(): time and hardware cache
+// misses (read through perf_event_open) for pops from heaps far larger
+// than the caches.
+//
+// Usage: ./bench_prefetch [elements ... = 10000000 100000000]
+//
+// To see what prefetching is worth, build it a second time without it and
+// compare the two runs:
+//     g++ -std=c++17 -O3 -DNDEBUG -DPQ_NO_PREFETCH bench_prefetch.cpp -o bench_noprefetch
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "BinaryPQ.hpp"
+
+namespace {
+
+// Counts hardware cache misses of this thread between start() and stop(),
+// or reports -1 where perf events are unavailable (e.g. in containers).
+class CacheMissCounter {
+public:
+    CacheMissCounter() {
+        perf_event_attr attr {};
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = PERF_COUNT_HW_CACHE_MISSES;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fd = static_cast<int>(::syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+    }
+
+    ~CacheMissCounter() {
+        if (fd >= 0) {
+            ::close(fd);
+        }
+    }
+
+    CacheMissCounter(const CacheMissCounter &) = delete;
+    CacheMissCounter &operator=(const CacheMissCounter &) = delete;
+
+    void start() {
+        if (fd >= 0) {
+            ::ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ::ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+
+    [[nodiscard]] long long stop() {
+        long long count = -1;
+        if (fd >= 0) {
+            ::ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+            if (::read(fd, &count, sizeof(count)) != sizeof(count)) {
+                count = -1;
+            }
+        }
+        return count;
+    }
+
+private:
+    int fd = -1;
+};
+
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+
+// Build a heap of n random keys, then time a fixed number of pops.
+void benchPops(std::size_t n) {
+    std::vector<std::uint64_t> keys(n);
+    std::mt19937_64 rng { 281 };  // NOLINT: fixed seed
+    for (auto &key : keys) {
+        key = rng();
+    }
+    BinaryPQ<std::uint64_t> pq { keys.cbegin(), keys.cend() };
+    keys = std::vector<std::uint64_t> {};
+
+    const std::size_t pops = std::min<std::size_t>(n, 2000000);  // NOLINT: enough to be stable
+    CacheMissCounter misses;
+    std::uint64_t checksum = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    misses.start();
+    for (std::size_t i = 0; i < pops; ++i) {
+        checksum ^= pq.top();
+        pq.pop();
+    }
+    long long missed = misses.stop();
+    double seconds = secondsSince(start);
+
+    std::cout << n << " elements: " << seconds * 1e9 / static_cast<double>(pops) << " ns/pop, ";
+    if (missed >= 0) {
+        std::cout << static_cast<double>(missed) / static_cast<double>(pops) << " cache misses/pop";
+    } else {
+        std::cout << "cache misses n/a";
+    }
+    std::cout << " (checksum " << checksum << ")" << std::endl;
+}
+
+}  // namespace
+
+
+int main(int argc, char *argv[]) {
+#ifdef PQ_NO_PREFETCH
+    std::cout << "BinaryPQ pops without prefetching" << std::endl;
+#else
+    std::cout << "BinaryPQ pops with prefetching" << std::endl;
+#endif
+
+    std::vector<std::size_t> sizes { 10000000, 100000000 };  // NOLINT: 10^7 and 10^8
+    if (argc > 1) {
+        sizes.clear();
+        for (int i = 1; i < argc; ++i) {
+            sizes.push_back(std::stoul(argv[i]));
+        }
+    }
+    for (auto n : sizes) {
+        benchPops(n);
+    }
+    return 0;
+}
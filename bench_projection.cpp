@@ -0,0 +1,87 @@
+// Project identifier: 43DE0E0C4C76BFAA6D8C2F5AEAE0518A9C42CF4E
+
+// Benchmark for by_key comparators: a workload of pop() then push() on
+// UnorderedPQ, UnorderedFastPQ and BinaryPQ of 16- and 32-byte jobs ordered
+// by their deadline, with a hand-written comparator and with
+// min_by_key<&Job::deadline>, for which the unordered PQs scan the keys of
+// the 16-byte jobs directly. Reports the time per pop() and push().
+//
+// Usage: ./bench_projection [elements = 4096] [operations = 20000]
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "BinaryPQ.hpp"
+#include "Projection.hpp"
+#include "UnorderedFastPQ.hpp"
+#include "UnorderedPQ.hpp"
+
+namespace {
+
+template<std::size_t WORDS>
+struct Job {
+    std::uint32_t deadline;
+    std::uint32_t id;
+    std::uint64_t payload[WORDS];
+};
+
+// Earlier deadlines have higher priority.
+struct JobComp {
+    template<typename JOB>
+    bool operator()(const JOB &a, const JOB &b) const { return a.deadline > b.deadline; }
+};
+
+
+template<typename PQ, typename JOB>
+void bench(const char *name, const std::vector<JOB> &jobs, std::size_t ops) {
+    PQ pq { jobs.begin(), jobs.end() };
+    std::mt19937 rng { 281 };  // NOLINT: fixed seed
+    std::uint64_t checksum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t op = 0; op < ops; ++op) {
+        JOB job = pq.top();
+        pq.pop();
+        checksum += job.id;
+        job.deadline += static_cast<std::uint32_t>(rng() % 1000);  // NOLINT: reschedule later
+        pq.push(job);
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "  " << name << ": " << seconds * 1e9 / static_cast<double>(ops)  // NOLINT: s to ns
+              << " ns/op (checksum " << checksum << ")" << std::endl;
+}
+
+
+template<std::size_t WORDS>
+void benchJobs(std::size_t n, std::size_t ops) {
+    using Item = Job<WORDS>;
+    std::mt19937 rng { 281 };  // NOLINT: fixed seed
+    std::vector<Item> jobs(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        jobs[i] = Item { static_cast<std::uint32_t>(rng() % 100000), static_cast<std::uint32_t>(i), {} };  // NOLINT
+    }
+
+    using ByDeadline = min_by_key<&Item::deadline>;
+    std::cout << n << " jobs of " << sizeof(Item) << " bytes" << std::endl;
+    bench<UnorderedPQ<Item, JobComp>>("Unordered, comparator", jobs, ops);
+    bench<UnorderedPQ<Item, ByDeadline>>("Unordered, by_key", jobs, ops);
+    bench<UnorderedFastPQ<Item, JobComp>>("UnorderedFast, comparator", jobs, ops);
+    bench<UnorderedFastPQ<Item, ByDeadline>>("UnorderedFast, by_key", jobs, ops);
+    bench<BinaryPQ<Item, JobComp>>("Binary, comparator", jobs, ops);
+    bench<BinaryPQ<Item, ByDeadline>>("Binary, by_key", jobs, ops);
+}
+
+}  // namespace
+
+
+int main(int argc, char *argv[]) {
+    const std::size_t n = argc > 1 ? std::stoul(argv[1]) : 4096;     // NOLINT: default size
+    const std::size_t ops = argc > 2 ? std::stoul(argv[2]) : 20000;  // NOLINT: default count
+
+    benchJobs<1>(n, ops);
+    benchJobs<3>(n, ops);  // NOLINT: 32 bytes
+    return 0;
+}
@@ -0,0 +1,404 @@
+// Project identifier: 43DE0E0C4C76BFAA6D8C2F5AEAE0518A9C42CF4E
+
+// Differential regression check: the same randomized operation traces run
+// against every PQ and against std::priority_queue as the reference. Every
+// top() and pop() of every PQ must return what the reference does, and
+// each run is timed, so a change that breaks the pop order or the
+// complexity of any PQ shows up here.
+//
+// Items are ids whose priorities live in a table the trace updates, so
+// updatePriorities() is checked as well, and ties are broken by id so that
+// every step has exactly one right answer. The traces are:
+//     random      pushes, pops and tops mixed, with many equal priorities
+//     ascending   rising priorities, a pop after every two pushes
+//     descending  falling priorities, the same way
+//     fill-drain  twice: size pushes, then size pops
+//     updates     random, with every priority changed every 500 operations
+//
+// Timings are the best of the repetitions in CPU ns per operation. Absolute
+// times only compare on the machine that took them, so each one is also
+// divided by the reference's best time on the same trace in the same
+// process, and only that ratio is kept: --record writes lines of
+// "trace backend ratio", --baseline compares against such a file, and the
+// exit status is 1 if any result differs from the reference or any ratio
+// is more than the tolerance above its baseline. 'make regress' runs it
+// against regress_baseline.txt.
+//
+// Usage: ./bench_regress [--baseline FILE] [--record FILE] [--tolerance PERCENT = 25]
+//                        [--size N = 10000] [--reps N = 5] [--seed N = 281]
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <queue>
+#include <random>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <time.h>
+
+#include "BatchPQ.hpp"
+#include "BinaryPQ.hpp"
+#include "ExternalPQ.hpp"
+#include "HollowPQ.hpp"
+#include "PairingPQ.hpp"
+#include "PersistentPQ.hpp"
+#include "SmallPQ.hpp"
+#include "SortedPQ.hpp"
+#include "UnorderedFastPQ.hpp"
+#include "UnorderedPQ.hpp"
+
+namespace {
+
+using Item = std::uint32_t;
+
+enum class OpKind : std::uint8_t { Push, Pop, Top, Update };
+
+struct Op {
+    OpKind kind;
+    std::uint64_t value;  // The priority to push, or the seed of an update
+};
+
+struct Trace {
+    std::string name;
+    std::vector<std::uint64_t> initial;  // Priorities of the items the PQ is built from
+    std::vector<Op> ops;
+    std::size_t items = 0;  // Items built from or pushed
+};
+
+// Orders items by the priority the trace gave them, then by id.
+struct ByPriority {
+    const std::vector<std::uint64_t> *priorities;
+
+    bool operator()(Item a, Item b) const {
+        std::uint64_t pa = (*priorities)[a];
+        std::uint64_t pb = (*priorities)[b];
+        return pa != pb ? pa < pb : a < b;
+    }
+};
+
+// The priority an update gives an item: a hash of the update's seed and
+// the item, in a small range so that ties stay common.
+std::uint64_t updatedPriority(std::uint64_t seed, Item item) {
+    std::uint64_t z = seed + 0x9e3779b97f4a7c15u * (item + 1u);  // NOLINT: splitmix64
+    z = (z ^ (z >> 30u)) * 0xbf58476d1ce4e5b9u;  // NOLINT: splitmix64
+    z = (z ^ (z >> 27u)) * 0x94d049bb133111ebu;  // NOLINT: splitmix64
+    return (z ^ (z >> 31u)) % 1000u;  // NOLINT: plenty of ties
+}
+
+
+// std::priority_queue, with updatePriorities() as a make_heap().
+template<typename TYPE, typename COMP_FUNCTOR>
+class ReferencePQ : public std::priority_queue<TYPE, std::vector<TYPE>, COMP_FUNCTOR> {
+    using Base = std::priority_queue<TYPE, std::vector<TYPE>, COMP_FUNCTOR>;
+
+public:
+    template<typename InputIterator>
+    ReferencePQ(InputIterator start, InputIterator end, COMP_FUNCTOR comp)
+        : Base { start, end, comp } {}
+
+    void updatePriorities() { std::make_heap(this->c.begin(), this->c.end(), this->comp); }
+};
+
+
+// CPU time used by this process, in seconds. Wall time would also count
+// the time other processes had the CPU, which a long run pays for more
+// often than a short one, skewing the ratios on a busy machine.
+double cpuSeconds() {
+    timespec now {};
+    ::clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &now);
+    return static_cast<double>(now.tv_sec) + static_cast<double>(now.tv_nsec) * 1e-9;  // NOLINT: ns to s
+}
+
+
+// What a run saw: every item top() and pop() returned, then the final size.
+struct Outcome {
+    std::vector<Item> observed;
+    double seconds = 0;
+};
+
+template<typename PQ>
+Outcome run(const Trace &trace) {
+    std::vector<std::uint64_t> priorities(trace.items);
+    std::copy(trace.initial.begin(), trace.initial.end(), priorities.begin());
+    std::vector<Item> built(trace.initial.size());
+    for (std::size_t i = 0; i < built.size(); ++i) {
+        built[i] = static_cast<Item>(i);
+    }
+
+    Outcome outcome;
+    outcome.observed.reserve(trace.ops.size() + 1);
+    double start = cpuSeconds();
+    PQ pq { built.begin(), built.end(), ByPriority { &priorities } };
+    auto next = static_cast<Item>(built.size());
+    for (const Op &op : trace.ops) {
+        switch (op.kind) {
+        case OpKind::Push:
+            priorities[next] = op.value;
+            pq.push(next++);
+            break;
+        case OpKind::Pop:
+            outcome.observed.push_back(pq.top());
+            pq.pop();
+            break;
+        case OpKind::Top:
+            outcome.observed.push_back(pq.top());
+            break;
+        case OpKind::Update:
+            for (Item item = 0; item < next; ++item) {
+                priorities[item] = updatedPriority(op.value, item);
+            }
+            pq.updatePriorities();
+            break;
+        }
+    }
+    outcome.observed.push_back(static_cast<Item>(pq.size()));
+    outcome.seconds = cpuSeconds() - start;
+    return outcome;
+}
+
+
+// Builds a trace, never popping an empty PQ.
+class TraceBuilder {
+public:
+    explicit TraceBuilder(std::string name) { trace.name = std::move(name); }
+
+    void initial(std::uint64_t priority) {
+        trace.initial.push_back(priority);
+        ++trace.items;
+        ++live;
+    }
+
+    void push(std::uint64_t priority) {
+        trace.ops.push_back(Op { OpKind::Push, priority });
+        ++trace.items;
+        ++live;
+    }
+
+    // Pop, or push priority if the PQ would be empty.
+    void pop(std::uint64_t priority) {
+        if (live == 0) {
+            push(priority);
+            return;
+        }
+        trace.ops.push_back(Op { OpKind::Pop, 0 });
+        --live;
+    }
+
+    void top(std::uint64_t priority) {
+        if (live == 0) {
+            push(priority);
+        }
+        trace.ops.push_back(Op { OpKind::Top, 0 });
+    }
+
+    void update(std::uint64_t seed) { trace.ops.push_back(Op { OpKind::Update, seed }); }
+
+    Trace done() { return std::move(trace); }
+
+private:
+    Trace trace;
+    std::size_t live = 0;
+};
+
+// Pushes, pops and tops in proportion 45:40:15, and an update every
+// update_every operations if that is not 0.
+Trace mixedTrace(const std::string &name, std::size_t size, std::mt19937_64 &rng, std::size_t update_every) {
+    TraceBuilder builder { name };
+    for (std::size_t i = 0; i < size / 2; ++i) {
+        builder.initial(rng() % size);
+    }
+    for (std::size_t i = 1; i <= 4 * size; ++i) {  // NOLINT: four operations per element
+        std::uint64_t roll = rng() % 100;  // NOLINT: percent
+        std::uint64_t priority = rng() % size;
+        if (update_every != 0 && i % update_every == 0) {
+            builder.update(rng());
+        } else if (roll < 45) {  // NOLINT: 45% pushes
+            builder.push(priority);
+        } else if (roll < 85) {  // NOLINT: 40% pops
+            builder.pop(priority);
+        } else {
+            builder.top(priority);
+        }
+    }
+    return builder.done();
+}
+
+// Two pushes, then a pop, with priorities rising or falling.
+Trace monotoneTrace(const std::string &name, std::size_t size, bool rising) {
+    TraceBuilder builder { name };
+    for (std::size_t i = 0; i < 2 * size; ++i) {
+        builder.push(rising ? i : 2 * size - i);
+        if (i % 2 == 1) {
+            builder.pop(0);
+        }
+    }
+    return builder.done();
+}
+
+Trace fillDrainTrace(std::size_t size, std::mt19937_64 &rng) {
+    TraceBuilder builder { "fill-drain" };
+    for (int round = 0; round < 2; ++round) {
+        for (std::size_t i = 0; i < size; ++i) {
+            builder.push(rng() % size);
+        }
+        for (std::size_t i = 0; i < size; ++i) {
+            builder.pop(0);
+        }
+    }
+    return builder.done();
+}
+
+
+struct Backend {
+    std::string name;
+    Outcome (*run)(const Trace &);
+};
+
+template<template<typename...> typename PQ>
+Backend backend(const std::string &name) {
+    return Backend { name, &run<PQ<Item, ByPriority>> };
+}
+
+using Baseline = std::map<std::pair<std::string, std::string>, double>;
+
+// First line of a baseline file, naming what its numbers are.
+const std::string kBaselineHeader = "# trace backend time/reference";
+
+Baseline readBaseline(const std::string &path) {
+    std::ifstream file { path };
+    if (!file) {
+        std::cerr << "Cannot read baseline " << path << std::endl;
+        std::exit(1);
+    }
+    Baseline baseline;
+    std::string line;
+    if (!std::getline(file, line) || line.compare(0, kBaselineHeader.size(), kBaselineHeader) != 0) {
+        std::cerr << path << " does not hold times relative to the reference; record it again" << std::endl;
+        std::exit(1);
+    }
+    while (std::getline(file, line)) {
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        std::istringstream fields { line };
+        std::string trace;
+        std::string name;
+        double ratio = 0;
+        if (fields >> trace >> name >> ratio) {
+            baseline[{ trace, name }] = ratio;
+        }
+    }
+    return baseline;
+}
+
+}  // namespace
+
+
+int main(int argc, char *argv[]) {
+    std::string baseline_path;
+    std::string record_path;
+    double tolerance = 25;  // NOLINT: percent
+    std::size_t size = 10000;  // NOLINT: default size
+    int reps = 5;  // NOLINT: default repetitions
+    std::uint64_t seed = 281;  // NOLINT: default seed
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string flag = argv[i];
+        std::string value = argv[i + 1];
+        if (flag == "--baseline") {
+            baseline_path = value;
+        } else if (flag == "--record") {
+            record_path = value;
+        } else if (flag == "--tolerance") {
+            tolerance = std::stod(value);
+        } else if (flag == "--size") {
+            size = std::stoul(value);
+        } else if (flag == "--reps") {
+            reps = std::max(1, std::stoi(value));
+        } else if (flag == "--seed") {
+            seed = std::stoull(value);
+        } else {
+            std::cerr << "Unknown option " << flag << std::endl;
+            return 1;
+        }
+    }
+
+    std::mt19937_64 rng { seed };
+    std::vector<Trace> traces;
+    traces.push_back(mixedTrace("random", size, rng, 0));
+    traces.push_back(monotoneTrace("ascending", size, true));
+    traces.push_back(monotoneTrace("descending", size, false));
+    traces.push_back(fillDrainTrace(size, rng));
+    traces.push_back(mixedTrace("updates", size, rng, 500));  // NOLINT: see above
+
+    const std::vector<Backend> backends {
+        backend<UnorderedPQ>("Unordered"),   backend<UnorderedFastPQ>("UnorderedFast"),
+        backend<SortedPQ>("Sorted"),         backend<BinaryPQ>("Binary"),
+        backend<PairingPQ>("Pairing"),       backend<ExternalPQ>("External"),
+        backend<HollowPQ>("Hollow"),         Backend { "Small", &run<SmallPQ<Item, ByPriority>> },
+        backend<PersistentPQ>("Persistent"), backend<BatchPQ>("Batch"),
+    };
+    Baseline baseline = baseline_path.empty() ? Baseline {} : readBaseline(baseline_path);
+    std::ofstream record;
+    if (!record_path.empty()) {
+        record.open(record_path);
+        record << kBaselineHeader << ", from ./bench_regress --size " << size << " --seed " << seed << "\n";
+    }
+
+    bool failed = false;
+    for (const Trace &trace : traces) {
+        Outcome first = run<ReferencePQ<Item, ByPriority>>(trace);
+        const std::vector<Item> &expected = first.observed;
+        double ns_per_op = 1e9 / double(std::max<std::size_t>(1, trace.ops.size()));  // NOLINT: ns
+        std::cout << trace.name << " (" << trace.ops.size() << " ops, reference " << std::fixed
+                  << std::setprecision(1) << first.seconds * ns_per_op << " ns/op):" << std::endl;
+        for (const Backend &pq : backends) {
+            // The reference is timed again next to every repetition, so
+            // that both sides of the ratio see the machine in the same
+            // state.
+            double best = 0;
+            double reference = 0;
+            for (int rep = 0; rep < reps; ++rep) {
+                double seconds = run<ReferencePQ<Item, ByPriority>>(trace).seconds;
+                reference = rep == 0 ? seconds : std::min(reference, seconds);
+                Outcome outcome = pq.run(trace);
+                auto mismatch = std::mismatch(outcome.observed.begin(), outcome.observed.end(), expected.begin(),
+                                              expected.end());
+                if (mismatch.first != outcome.observed.end() || mismatch.second != expected.end()) {
+                    std::cout << "  " << pq.name << ": WRONG at result "
+                              << mismatch.first - outcome.observed.begin() << std::endl;
+                    failed = true;
+                    break;
+                }
+                best = rep == 0 ? outcome.seconds : std::min(best, outcome.seconds);
+            }
+            double ratio = best / std::max(reference, 1e-9);  // NOLINT: avoid dividing by 0
+            std::cout << "  " << std::left << std::setw(14) << pq.name << std::right  // NOLINT: names
+                      << std::setprecision(1) << std::setw(9) << best * ns_per_op << " ns/op"  // NOLINT: columns
+                      << std::setprecision(2) << std::setw(8) << ratio << "x ref";  // NOLINT: columns
+            auto base = baseline.find({ trace.name, pq.name });
+            if (base != baseline.end()) {
+                double change = (ratio / base->second - 1) * 100;  // NOLINT: percent
+                std::cout << std::setprecision(1) << " (" << (change >= 0 ? "+" : "") << change << "%)";
+                if (change > tolerance) {
+                    std::cout << " SLOWER than " << std::setprecision(2) << base->second << "x ref by more than "
+                              << tolerance << "%";
+                    failed = true;
+                }
+            }
+            std::cout << std::endl;
+            if (record.is_open()) {
+                record << trace.name << " " << pq.name << " " << ratio << "\n";
+            }
+        }
+    }
+    std::cout << (failed ? "Regression check FAILED" : "Regression check passed") << std::endl;
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,59 @@
+// Project identifier: 43DE0E0C4C76BFAA6D8C2F5AEAE0518A9C42CF4E
+
+// Benchmark for SharedBinaryPQ: 1, 2, 4 and 8 worker processes share one
+// heap, each pushing a job and popping one in a loop, as workers that
+// generate follow-up work would. Reports the total rate of operations,
+// which shows how much the shared lock costs as processes are added.
+//
+// Usage: ./bench_shared [operations per process = 1000000]
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "SharedBinaryPQ.hpp"
+
+int main(int argc, char *argv[]) {
+    const std::size_t ops = argc > 1 ? std::stoul(argv[1]) : 1000000;  // NOLINT: default count
+    const std::string name = "/pq281-bench-" + std::to_string(getpid());
+
+    for (int processes : { 1, 2, 4, 8 }) {  // NOLINT: process counts
+        SharedBinaryPQ<std::uint64_t>::remove(name);
+        SharedBinaryPQ<std::uint64_t> queue { name, 1 << 20 };  // NOLINT: ample capacity
+        for (std::uint64_t i = 0; i < 10000; ++i) {  // NOLINT: standing backlog of jobs
+            queue.push(i * 2654435761U % 1000003);  // NOLINT: scrambled keys
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        std::vector<pid_t> children;
+        for (int p = 0; p < processes; ++p) {
+            pid_t pid = fork();
+            if (pid == 0) {
+                SharedBinaryPQ<std::uint64_t> worker { name };
+                std::uint64_t job = 0;
+                for (std::size_t i = 0; i < ops; ++i) {
+                    worker.push((job + i) * 2654435761U % 1000003);  // NOLINT: scrambled keys
+                    worker.tryPop(job);
+                }
+                _exit(0);
+            }
+            children.push_back(pid);
+        }
+        for (pid_t child : children) {
+            waitpid(child, nullptr, 0);
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        auto total = 2 * ops * static_cast<std::size_t>(processes);
+        std::cout << processes << " process(es): " << static_cast<double>(total) / seconds / 1e6  // NOLINT: to millions
+                  << " M ops/s, " << seconds * 1e9 / static_cast<double>(total)                  // NOLINT: s to ns
+                  << " ns/op (heap holds " << queue.size() << ")" << std::endl;
+    }
+    SharedBinaryPQ<std::uint64_t>::remove(name);
+    return 0;
+}
@@ -0,0 +1,82 @@
+// Project identifier: 43DE0E0C4C76BFAA6D8C2F5AEAE0518A9C42CF4E
+
+// Benchmark for the simulation kernel: the classic hold model. The queue
+// starts with n events, and handling each one schedules a new one at an
+// exponentially distributed time later, so the queue stays at n events.
+// Runs with BinaryPQ, PairingPQ and CalendarQueue as the event queue, for
+// n = 1000, 10000, ... up to the given size, and reports events per second.
+//
+// Usage: ./bench_sim [max events pending = 1000000] [events handled = 5000000]
+//                    [mean time between events = 1000]
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+
+#include "BinaryPQ.hpp"
+#include "PairingPQ.hpp"
+#include "Simulation.hpp"
+
+namespace {
+
+// A payload of a typical size; the kernel never copies it.
+struct Job {
+    std::uint64_t id;
+    std::array<std::uint64_t, 6> state {};  // NOLINT: 56 bytes in all
+
+    explicit Job(std::uint64_t id) : id { id } {}
+};
+
+
+template<template<typename...> typename QUEUE>
+void hold(const char *name, std::size_t pending, std::size_t events, double mean) {
+    std::mt19937_64 rng { 281 };  // NOLINT: fixed seed
+    std::exponential_distribution<double> delay { 1 / mean };
+    auto next = [&rng, &delay] { return static_cast<SimTime>(delay(rng)); };
+
+    Simulation<Job, QUEUE> sim {};
+    std::uint64_t id = 0;
+    for (std::size_t i = 0; i < pending; ++i) {
+        sim.schedule(next(), id++);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::uint64_t checksum = 0;
+    std::size_t batches = 0;
+    std::size_t handled = 0;
+    while (handled < events) {
+        handled += sim.run(
+            [&](Simulation<Job, QUEUE> &s, const typename Simulation<Job, QUEUE>::Batch &batch) {
+                ++batches;
+                for (const Job &job : batch) {
+                    checksum += job.id;
+                    s.schedule(s.now() + next(), id++);
+                }
+            },
+            sim.now() + static_cast<SimTime>(mean));
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "  " << name << ": " << static_cast<double>(handled) / seconds / 1e6  // NOLINT: millions
+              << " M events/s, " << static_cast<double>(handled) / static_cast<double>(batches)
+              << " events/batch (checksum " << checksum << ")" << std::endl;
+}
+
+}  // namespace
+
+
+int main(int argc, char *argv[]) {
+    const std::size_t max_pending = argc > 1 ? std::stoul(argv[1]) : 1000000;  // NOLINT: default size
+    const std::size_t events = argc > 2 ? std::stoul(argv[2]) : 5000000;       // NOLINT: default count
+    const double mean = argc > 3 ? std::stod(argv[3]) : 1000;                  // NOLINT: default ticks
+
+    for (std::size_t pending = 1000; pending <= max_pending; pending *= 10) {  // NOLINT: sizes
+        std::cout << pending << " events pending" << std::endl;
+        hold<BinaryPQ>("Binary", pending, events, mean);
+        hold<PairingPQ>("Pairing", pending, events, mean);
+        hold<CalendarQueue>("Calendar (timing wheel)", pending, events, mean);
+    }
+    return 0;
+}
@@ -0,0 +1,88 @@
+// Project identifier: 43DE0E0C4C76BFAA6D8C2F5AEAE0518A9C42CF4E
+
+// Benchmark for SmallPQ: millions of short-lived queues that mostly hold
+// 8 elements or fewer (1 in 20 holds up to 24), each filled and drained.
+// Reports time and heap allocations per queue for BinaryPQ,
+// UnorderedFastPQ and SmallPQ.
+//
+// Usage: ./bench_small [queues = 2000000]
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "BinaryPQ.hpp"
+#include "SmallPQ.hpp"
+#include "UnorderedFastPQ.hpp"
+
+namespace {
+
+std::uint64_t allocations = 0;
+
+}  // namespace
+
+
+// Count every allocation the program makes.
+void *operator new(std::size_t size) {
+    ++allocations;
+    if (void *ptr = std::malloc(size == 0 ? 1 : size)) {
+        return ptr;
+    }
+    throw std::bad_alloc {};
+}
+
+void operator delete(void *ptr) noexcept { std::free(ptr); }
+void operator delete(void *ptr, std::size_t) noexcept { std::free(ptr); }
+
+
+namespace {
+
+template<typename PQ>
+void benchQueues(const char *name, const std::vector<std::uint32_t> &sizes, const std::vector<std::uint32_t> &keys) {
+    std::uint64_t before = allocations;
+    std::uint64_t checksum = 0;
+    std::size_t next_key = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (auto size : sizes) {
+        PQ pq {};
+        for (std::uint32_t i = 0; i < size; ++i) {
+            pq.push(keys[next_key++ % keys.size()]);
+        }
+        while (!pq.empty()) {
+            checksum += pq.top();
+            pq.pop();
+        }
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    auto queues = static_cast<double>(sizes.size());
+    std::cout << name << ": " << seconds * 1e9 / queues << " ns/queue, "  // NOLINT: s to ns
+              << static_cast<double>(allocations - before) / queues << " allocations/queue (checksum " << checksum
+              << ")" << std::endl;
+}
+
+}  // namespace
+
+
+int main(int argc, char *argv[]) {
+    const std::size_t n = argc > 1 ? std::stoul(argv[1]) : 2000000;  // NOLINT: default count
+
+    std::mt19937 rng { 281 };  // NOLINT: fixed seed
+    std::vector<std::uint32_t> sizes(n);
+    for (auto &size : sizes) {
+        size = static_cast<std::uint32_t>(rng() % 20 == 0 ? rng() % 24 + 1 : rng() % 8 + 1);  // NOLINT: mostly up to 8
+    }
+    std::vector<std::uint32_t> keys(1 << 16);  // NOLINT: reused key pool
+    for (auto &key : keys) {
+        key = static_cast<std::uint32_t>(rng());
+    }
+
+    benchQueues<BinaryPQ<std::uint32_t>>("Binary", sizes, keys);
+    benchQueues<UnorderedFastPQ<std::uint32_t>>("UnorderedFast", sizes, keys);
+    benchQueues<SmallPQ<std::uint32_t>>("Small (8 inline)", sizes, keys);
+    return 0;
+}
@@ -0,0 +1,71 @@
+// Project identifier: 43DE0E0C4C76BFAA6D8C2F5AEAE0518A9C42CF4E
+
+// Benchmark for PQ snapshots: save() and load() throughput of every
+// in-memory PQ, through an in-memory stream so the disk is not measured.
+//
+// Usage: ./bench_snapshot [elements = 4194304]
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "BinaryPQ.hpp"
+#include "PairingPQ.hpp"
+#include "SortedPQ.hpp"
+#include "UnorderedFastPQ.hpp"
+#include "UnorderedPQ.hpp"
+
+namespace {
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+
+// Save a PQ built from keys, load it back, and report both rates.
+template<template<typename...> typename PQ>
+void benchSnapshot(const char *name, const std::vector<std::uint64_t> &keys) {
+    PQ<std::uint64_t> pq { keys.cbegin(), keys.cend() };
+    std::stringstream stream;
+
+    auto start = std::chrono::steady_clock::now();
+    pq.save(stream);
+    double save_s = secondsSince(start);
+
+    PQ<std::uint64_t> reloaded {};
+    start = std::chrono::steady_clock::now();
+    reloaded.load(stream);
+    double load_s = secondsSince(start);
+
+    const double gb = static_cast<double>(keys.size() * sizeof(std::uint64_t)) / 1e9;
+    std::cout << name << ": save " << gb / save_s << " GB/s, load " << gb / load_s << " GB/s";
+    if (reloaded.size() != pq.size() || reloaded.top() != pq.top()) {
+        std::cout << " (MISMATCH)";
+    }
+    std::cout << std::endl;
+}
+
+}  // namespace
+
+
+int main(int argc, char *argv[]) {
+    const std::size_t n = argc > 1 ? std::stoul(argv[1]) : std::size_t { 1 } << 22u;  // NOLINT: default size
+
+    std::vector<std::uint64_t> keys(n);
+    std::mt19937_64 rng { 281 };  // NOLINT: fixed seed
+    for (auto &key : keys) {
+        key = rng();
+    }
+
+    std::cout << "Snapshots of " << n << " 64-bit keys" << std::endl;
+    benchSnapshot<UnorderedPQ>("Unordered", keys);
+    benchSnapshot<UnorderedFastPQ>("UnorderedFast", keys);
+    benchSnapshot<SortedPQ>("Sorted", keys);
+    benchSnapshot<BinaryPQ>("Binary", keys);
+    benchSnapshot<PairingPQ>("Pairing", keys);
+    return 0;
+}
@@ -0,0 +1,83 @@
+// Project identifier: 43DE0E0C4C76BFAA6D8C2F5AEAE0518A9C42CF4E
+
+// Benchmark for pq_sort(): sorts the same random uint64 values with
+//   - pq_sort() on 1, 2, 4, ... threads up to the number of hardware threads,
+//   - a pop loop over a BinaryPQ, the way the PQs were used to sort before,
+//   - std::sort, and
+//   - std::sort(std::execution::par), when built with TBB=1 (see Makefile).
+// Reports the time per element sorted.
+//
+// Usage: ./bench_sort [elements = 16777216] [max threads]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#ifdef PQ_HAVE_TBB
+#include <execution>
+#endif
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "BinaryPQ.hpp"
+#include "PQSort.hpp"
+
+namespace {
+
+template<typename Sort>
+void bench(const std::string &name, const std::vector<std::uint64_t> &values,
+           const std::vector<std::uint64_t> &expected, Sort sort) {
+    std::vector<std::uint64_t> data { values };
+    auto start = std::chrono::steady_clock::now();
+    sort(data);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (data != expected) {
+        std::cerr << name << ": output is not sorted" << std::endl;
+        std::exit(1);
+    }
+    std::cout << name << ": " << seconds * 1e9 / static_cast<double>(values.size())  // NOLINT: s to ns
+              << " ns/element" << std::endl;
+}
+
+}  // namespace
+
+
+int main(int argc, char *argv[]) {
+    const std::size_t n = argc > 1 ? std::stoul(argv[1]) : std::size_t { 1 } << 24u;  // NOLINT: default size
+    const unsigned max_threads = argc > 2 ? static_cast<unsigned>(std::stoul(argv[2]))
+                                          : std::max(1u, std::thread::hardware_concurrency());
+
+    std::mt19937_64 rng { 281 };  // NOLINT: fixed seed
+    std::vector<std::uint64_t> values(n);
+    for (auto &value : values) {
+        value = rng();
+    }
+    std::vector<std::uint64_t> expected { values };
+    std::sort(expected.begin(), expected.end());
+    std::cout << n << " elements" << std::endl;
+
+    bench("BinaryPQ pop loop", values, expected, [](std::vector<std::uint64_t> &data) {
+        BinaryPQ<std::uint64_t> heap { data.begin(), data.end() };
+        for (auto out = data.rbegin(); out != data.rend(); ++out) {
+            *out = heap.top();
+            heap.pop();
+        }
+    });
+    for (unsigned threads = 1; threads <= max_threads; threads *= 2) {
+        ParallelOptions options;
+        options.threads = threads;
+        bench("pq_sort, " + std::to_string(threads) + " threads", values, expected,
+              [options](std::vector<std::uint64_t> &data) {
+                  pq_sort(data.begin(), data.end(), std::less<std::uint64_t> {}, options);
+              });
+    }
+    bench("std::sort", values, expected,
+          [](std::vector<std::uint64_t> &data) { std::sort(data.begin(), data.end()); });
+#ifdef PQ_HAVE_TBB
+    bench("std::sort(par)", values, expected,
+          [](std::vector<std::uint64_t> &data) { std::sort(std::execution::par, data.begin(), data.end()); });
+#endif
+    return 0;
+}
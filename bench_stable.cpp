@@ -0,0 +1,103 @@
+// Project identifier: 43DE0E0C4C76BFAA6D8C2F5AEAE0518A9C42CF4E
+
+// Benchmark for stable mode: pushing and popping keys with many ties,
+// unstable, in stable mode, and with the usual workaround of wrapping each
+// key with a 64-bit sequence number and a comparator that breaks ties on
+// it.
+//
+// Usage: ./bench_stable [elements = 1000000]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "BinaryPQ.hpp"
+#include "PairingPQ.hpp"
+#include "SortedPQ.hpp"
+
+namespace {
+
+// The wrapper that stable mode replaces.
+struct Sequenced {
+    std::uint32_t key;
+    std::uint64_t sequence;
+};
+
+struct SequencedComp {
+    bool operator()(const Sequenced &a, const Sequenced &b) const {
+        return a.key < b.key || (a.key == b.key && a.sequence > b.sequence);
+    }
+};
+
+std::uint64_t keyOf(std::uint32_t key) { return key; }
+std::uint64_t keyOf(const Sequenced &item) { return item.key; }
+
+
+// Push every key, then pop them all; returns the best of a few runs, in
+// seconds.
+template<typename PQ, typename Make>
+double runWorkload(PQ &pq, const std::vector<std::uint32_t> &keys, Make make) {
+    double best = 1e9;  // NOLINT: larger than any run
+    for (int run = 0; run < 3; ++run) {
+        auto start = std::chrono::steady_clock::now();
+        std::uint64_t sequence = 0;
+        for (auto key : keys) {
+            pq.push(make(key, sequence++));
+        }
+        std::uint64_t checksum = 0;
+        while (!pq.empty()) {
+            checksum += keyOf(pq.top());
+            pq.pop();
+        }
+        best = std::min(best, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+        if (checksum == 0) {
+            std::cout << "";  // Keep the loop from being optimized away
+        }
+    }
+    return best;
+}
+
+
+template<template<typename...> typename PQ>
+void benchStable(const char *name, const std::vector<std::uint32_t> &keys) {
+    auto plainKey = [](std::uint32_t key, std::uint64_t) { return key; };
+    auto wrapKey = [](std::uint32_t key, std::uint64_t sequence) { return Sequenced { key, sequence }; };
+
+    PQ<std::uint32_t> unstable {};
+    double unstable_s = runWorkload(unstable, keys, plainKey);
+
+    PQ<std::uint32_t> stable {};
+    stable.setStable(true);
+    double stable_s = runWorkload(stable, keys, plainKey);
+
+    PQ<Sequenced, SequencedComp> wrapped {};
+    double wrapped_s = runWorkload(wrapped, keys, wrapKey);
+
+    std::cout << name << ": unstable " << unstable_s << " s, stable mode " << stable_s << " s, wrapped "
+              << wrapped_s << " s (stable mode " << (stable_s / wrapped_s - 1) * 100 << "% vs wrapped)"  // NOLINT
+              << std::endl;
+}
+
+}  // namespace
+
+
+int main(int argc, char *argv[]) {
+    const std::size_t n = argc > 1 ? std::stoul(argv[1]) : 1000000;  // NOLINT: default size
+
+    // Few distinct keys, so most comparisons are ties.
+    std::vector<std::uint32_t> keys(n);
+    std::mt19937 rng { 281 };  // NOLINT: fixed seed
+    for (auto &key : keys) {
+        key = static_cast<std::uint32_t>(rng() % 1000);  // NOLINT: many ties
+    }
+
+    benchStable<BinaryPQ>("Binary", keys);
+    benchStable<PairingPQ>("Pairing", keys);
+    keys.resize(std::min<std::size_t>(n, 50000));  // NOLINT: SortedPQ pushes are O(n)
+    benchStable<SortedPQ>("Sorted", keys);
+    return 0;
+}
@@ -0,0 +1,132 @@
+// Project identifier: 43DE0E0C4C76BFAA6D8C2F5AEAE0518A9C42CF4E
+
+// Benchmark for TimingWheelPQ: replays a timer trace against it and against
+// BinaryPQ with lazy erase. The trace is generated: the clock advances a
+// millisecond tick at a time, timers are armed with deadlines from 1 ms to
+// 4 hours (mostly short), and most of them are cancelled before they fire,
+// as request timeouts are. Every tick, the timers that are due are popped.
+//
+// Usage: ./bench_timers [timers = 2000000] [percent cancelled = 80]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <queue>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "BinaryPQ.hpp"
+#include "TimingWheelPQ.hpp"
+
+namespace {
+
+struct Timer {
+    std::uint64_t deadline;
+    std::uint32_t id;
+};
+
+// Earlier deadlines have higher priority.
+struct TimerComp {
+    bool operator()(const Timer &a, const Timer &b) const { return a.deadline > b.deadline; }
+};
+
+struct TimerDeadline {
+    std::uint64_t operator()(const Timer &timer) const { return timer.deadline; }
+};
+
+struct Event {
+    enum Kind : std::uint8_t { Schedule, Cancel, Tick } kind;
+    std::uint32_t id;
+    std::uint64_t time;  // The deadline to schedule, or the tick reached
+};
+
+
+std::vector<Event> makeTrace(std::size_t timers, unsigned cancelled) {
+    std::mt19937_64 rng { 281 };  // NOLINT: fixed seed
+    std::vector<Event> trace;
+    using Pending = std::pair<std::uint64_t, std::uint32_t>;  // Cancel time and id
+    std::priority_queue<Pending, std::vector<Pending>, std::greater<Pending>> cancels;
+    std::uint64_t now = 0;
+    for (std::uint32_t id = 0; id < timers; ++id) {
+        if (rng() % 4 == 0) {  // NOLINT: a new tick every 4 timers on average
+            ++now;
+            while (!cancels.empty() && cancels.top().first <= now) {
+                trace.push_back({ Event::Cancel, cancels.top().second, 0 });
+                cancels.pop();
+            }
+            trace.push_back({ Event::Tick, 0, now });
+        }
+        std::uint64_t delay = 0;
+        auto kind = rng() % 10;  // NOLINT: 60% short, 30% medium, 10% long
+        if (kind < 6) {  // NOLINT: up to 100 ms
+            delay = 1 + rng() % 100;
+        } else if (kind < 9) {  // NOLINT: up to a minute
+            delay = 100 + rng() % 60000;
+        } else {  // Up to 4 hours
+            delay = 60000 + rng() % (4 * 3600000);
+        }
+        trace.push_back({ Event::Schedule, id, now + delay });
+        if (rng() % 100 < cancelled) {  // NOLINT: percent
+            cancels.push({ now + rng() % delay, id });
+        }
+    }
+    return trace;
+}
+
+
+template<typename Replay>
+void bench(const char *name, const std::vector<Event> &trace, Replay replay) {
+    auto start = std::chrono::steady_clock::now();
+    std::uint64_t checksum = replay(trace);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << name << ": " << seconds * 1e9 / static_cast<double>(trace.size())  // NOLINT: s to ns
+              << " ns/event (checksum " << checksum << ")" << std::endl;
+}
+
+}  // namespace
+
+
+int main(int argc, char *argv[]) {
+    const std::size_t timers = argc > 1 ? std::stoul(argv[1]) : 2000000;  // NOLINT: default count
+    const auto cancelled = static_cast<unsigned>(argc > 2 ? std::stoul(argv[2]) : 80);  // NOLINT: default
+    const std::vector<Event> trace = makeTrace(timers, cancelled);
+    std::cout << trace.size() << " events, " << timers << " timers, " << cancelled << "% cancelled" << std::endl;
+
+    bench("Binary, lazy erase", trace, [timers](const std::vector<Event> &events) {
+        BinaryPQ<Timer, TimerComp> pq {};
+        std::vector<BinaryPQ<Timer, TimerComp>::Handle> handles(timers);
+        std::uint64_t checksum = 0;
+        for (const Event &event : events) {
+            if (event.kind == Event::Schedule) {
+                handles[event.id] = pq.pushHandle({ event.time, event.id });
+            } else if (event.kind == Event::Cancel) {
+                pq.erase(handles[event.id]);
+            } else {
+                while (!pq.empty() && pq.top().deadline <= event.time) {
+                    checksum += pq.top().id;
+                    pq.pop();
+                }
+            }
+        }
+        return checksum;
+    });
+
+    bench("TimingWheel", trace, [timers](const std::vector<Event> &events) {
+        TimingWheelPQ<Timer, TimerComp, TimerDeadline> wheel {};
+        std::vector<TimingWheelPQ<Timer, TimerComp, TimerDeadline>::Handle> handles(timers);
+        std::uint64_t checksum = 0;
+        for (const Event &event : events) {
+            if (event.kind == Event::Schedule) {
+                handles[event.id] = wheel.schedule({ event.time, event.id });
+            } else if (event.kind == Event::Cancel) {
+                wheel.cancel(handles[event.id]);
+            } else {
+                wheel.expire(event.time, [&checksum](const Timer &timer) { checksum += timer.id; });
+            }
+        }
+        return checksum;
+    });
+    return 0;
+}
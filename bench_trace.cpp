@@ -0,0 +1,80 @@
+// Project identifier: 43DE0E0C4C76BFAA6D8C2F5AEAE0518A9C42CF4E
+
+// Benchmark for the cost of TracedPQ: the same push/pop workload on a plain
+// PQ and on a traced one timing every operation or one in 64, then the
+// latency report of the sampled run.
+//
+// Usage: ./bench_trace [elements = 1000000]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "BinaryPQ.hpp"
+#include "PairingPQ.hpp"
+#include "TracedPQ.hpp"
+
+namespace {
+
+// Push every key, then pop them all; returns the best of a few runs, in
+// seconds.
+template<typename PQ>
+double runWorkload(PQ &pq, const std::vector<std::uint64_t> &keys) {
+    double best = 1e9;  // NOLINT: larger than any run
+    for (int run = 0; run < 3; ++run) {
+        auto start = std::chrono::steady_clock::now();
+        for (auto key : keys) {
+            pq.push(key);
+        }
+        std::uint64_t checksum = 0;
+        while (!pq.empty()) {
+            checksum += pq.top();
+            pq.pop();
+        }
+        best = std::min(best, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+        if (checksum == 0) {
+            std::cout << "";  // Keep the loop from being optimized away
+        }
+    }
+    return best;
+}
+
+
+template<template<typename...> typename PQ>
+void benchTrace(const char *name, const std::vector<std::uint64_t> &keys) {
+    PQ<std::uint64_t> plain {};
+    double plain_s = runWorkload(plain, keys);
+
+    TracedPQ<PQ<std::uint64_t>> every {};
+    every.setSampling(1);
+    double every_s = runWorkload(every, keys);
+
+    TracedPQ<PQ<std::uint64_t>> sampled {};
+    double sampled_s = runWorkload(sampled, keys);
+
+    std::cout << name << ": plain " << plain_s << " s, every op " << every_s << " s (+"
+              << (every_s / plain_s - 1) * 100 << "%), 1 in " << TracedPQ<PQ<std::uint64_t>>::kDefaultSampling
+              << " ops " << sampled_s << " s (+" << (sampled_s / plain_s - 1) * 100 << "%)" << std::endl;  // NOLINT
+    sampled.report(std::cout);
+}
+
+}  // namespace
+
+
+int main(int argc, char *argv[]) {
+    const std::size_t n = argc > 1 ? std::stoul(argv[1]) : 1000000;  // NOLINT: default size
+
+    std::vector<std::uint64_t> keys(n);
+    std::mt19937_64 rng { 281 };  // NOLINT: fixed seed
+    for (auto &key : keys) {
+        key = rng();
+    }
+
+    benchTrace<BinaryPQ>("Binary", keys);
+    benchTrace<PairingPQ>("Pairing", keys);
+    return 0;
+}
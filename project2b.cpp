@@ -24,25 +24,68 @@
  * do.
  */
 
+#include <algorithm>
+#include <array>
 #include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <functional>
 #include <iostream>
+#include <limits>
+#include <memory_resource>
 #include <ostream>
+#include <random>
+#include <set>
+#include <sstream>
 #include <stdexcept>
 #include <string>
+#include <type_traits>
 #include <vector>
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "BatchPQ.hpp"
 #include "BinaryPQ.hpp"
+#if __cplusplus >= 202002L
+#include "AsyncPQ.hpp"
+#endif
 #include "Eecs281PQ.hpp"
+#include "ExternalPQ.hpp"
+#include "HollowPQ.hpp"
+#include "HugePages.hpp"
+#include "KWayMerge.hpp"
+#include "MappedBinaryPQ.hpp"
+#include "PQSort.hpp"
 #include "PairingPQ.hpp"
+#include "PersistentPQ.hpp"
+#include "Projection.hpp"
+#include "SharedBinaryPQ.hpp"
+#include "Simulation.hpp"
+#include "SmallPQ.hpp"
 #include "SortedPQ.hpp"
+#include "TimingWheelPQ.hpp"
+#include "TracedPQ.hpp"
+#include "UnorderedFastPQ.hpp"
 #include "UnorderedPQ.hpp"
 
 // A type for representing priority queue types at runtime
 enum class PQType {
     Unordered,
+    UnorderedFast,
     Sorted,
     Binary,
     Pairing,
+    External,
+    Hollow,
+    Small,
+    TimingWheel,
+    Persistent,
+    Batch,
 };
 
 // These can be pretty-printed :)
@@ -50,24 +93,90 @@ std::ostream &operator<<(std::ostream &ost, PQType pqType) {
     switch (pqType) {
     case PQType::Unordered:
         return ost << "Unordered";
+    case PQType::UnorderedFast:
+        return ost << "UnorderedFast";
     case PQType::Sorted:
         return ost << "Sorted";
     case PQType::Binary:
         return ost << "Binary";
     case PQType::Pairing:
         return ost << "Pairing";
+    case PQType::External:
+        return ost << "External";
+    case PQType::Hollow:
+        return ost << "Hollow";
+    case PQType::Small:
+        return ost << "Small";
+    case PQType::TimingWheel:
+        return ost << "TimingWheel";
+    case PQType::Persistent:
+        return ost << "Persistent";
+    case PQType::Batch:
+        return ost << "Batch";
     }
 
     return ost << "Unknown PQType";
 }
 
 
+// A SmallPQ that spills to its heap after two elements, so that the
+// generic tests exercise both of its layouts.
+template <typename TYPE, typename COMP_FUNCTOR = std::less<TYPE>>
+using TinyPQ = SmallPQ<TYPE, COMP_FUNCTOR, 2>;
+
+
+// An allocator that counts the allocations made through it and its copies,
+// including rebound ones.
+template <typename T>
+struct CountingAllocator {
+    using value_type = T;
+
+    explicit CountingAllocator(std::size_t *counter)
+        : count { counter } {}
+
+    template <typename U>
+    CountingAllocator(const CountingAllocator<U> &other)  // NOLINT: implicit rebind
+        : count { other.count } {}
+
+    T *allocate(std::size_t n) {
+        ++*count;
+        return std::allocator<T> {}.allocate(n);
+    }
+
+    void deallocate(T *ptr, std::size_t n) { std::allocator<T> {}.deallocate(ptr, n); }
+
+    template <typename U>
+    bool operator==(const CountingAllocator<U> &other) const { return count == other.count; }
+    template <typename U>
+    bool operator!=(const CountingAllocator<U> &other) const { return count != other.count; }
+
+    std::size_t *count;
+};
+
+
 // Compares two int const* on the integers they point to
 struct IntPtrComp {
     bool operator()(const int *a, const int *b) const { return *a < *b; }
 };
 
 
+// An element with a priority and an identity, to check the order of ties.
+struct Event {
+    int key;
+    int id;
+};
+
+// Compares Events on their keys only
+struct EventComp {
+    bool operator()(const Event &a, const Event &b) const { return a.key < b.key; }
+};
+
+// Compares Event const* on the keys they point to
+struct EventPtrComp {
+    bool operator()(const Event *a, const Event *b) const { return a->key < b->key; }
+};
+
+
 // Test the primitive operations on a priority queue:
 // constructor, push, pop, top, size, empty.
 template <template <typename...> typename PQ>
@@ -154,6 +263,360 @@ void testUpdatePriorities() {
 }
 
 
+// Test that a snapshot reloads into an identical PQ, and that any PQ can
+// load another PQ's snapshot.
+template <template <typename...> typename PQ>
+void testSnapshot() {
+    std::cout << "Testing save and load..." << std::endl;
+
+    std::vector<int> vec;
+    for (int i = 0; i < 500; ++i) {  // NOLINT: arbitrary size
+        vec.push_back((i * 7919) % 503);  // NOLINT: scrambled order
+    }
+    PQ<int> original { vec.cbegin(), vec.cend() };
+
+    std::stringstream snapshot;
+    original.save(snapshot);
+    PQ<int> reloaded {};
+    reloaded.push(-1);  // Replaced by the load
+    reloaded.load(snapshot);
+
+    BinaryPQ<int> binary { vec.cbegin(), vec.cend() };
+    std::stringstream binarySnapshot;
+    binary.save(binarySnapshot);
+    PQ<int> converted {};
+    converted.load(binarySnapshot);
+
+    assert(reloaded.size() == vec.size());
+    assert(converted.size() == vec.size());
+    while (!original.empty()) {
+        assert(reloaded.top() == original.top());
+        assert(converted.top() == original.top());
+        original.pop();
+        reloaded.pop();
+        converted.pop();
+    }
+    assert(reloaded.empty());
+
+    // A truncated snapshot throws and leaves the PQ as it was.
+    PQ<int> kept { vec.cbegin(), vec.cend() };
+    std::stringstream full;
+    kept.save(full);
+    std::stringstream truncated { full.str().substr(0, full.str().size() - sizeof(int)) };
+    bool threw = false;
+    try {
+        kept.load(truncated);
+    } catch (const std::runtime_error &) {
+        threw = true;
+    }
+    assert(threw);
+    (void)threw;
+    assert(kept.size() == vec.size());
+    assert(kept.top() == *std::max_element(vec.begin(), vec.end()));
+
+    std::cout << "testSnapshot succeeded!" << std::endl;
+}
+
+
+// Test that rebuilding on several threads gives a valid PQ, for the PQs
+// that support it.
+template <template <typename...> typename PQ>
+void testParallel() {
+    std::cout << "Testing parallel rebuilds..." << std::endl;
+
+    ParallelOptions parallel;
+    parallel.threads = 3;   // NOLINT: uneven split on purpose
+    parallel.min_size = 0;  // Always use threads
+
+    std::vector<int> data;
+    for (int i = 0; i < 5000; ++i) {  // NOLINT: arbitrary size
+        data.push_back((i * 7919) % 4999);  // NOLINT: scrambled order
+    }
+    PQ<int> built { data.cbegin(), data.cend(), std::less<int> {}, parallel };
+    std::vector<int> expected { data };
+    std::sort(expected.rbegin(), expected.rend());
+    std::vector<int> popped;
+    while (!built.empty()) {
+        popped.push_back(built.top());
+        built.pop();
+    }
+    assert(popped == expected);
+
+    // Rebuild a PQ of pointers after every priority has changed.
+    PQ<const int *, IntPtrComp> rebuilt {};
+    rebuilt.setParallelism(parallel);
+    for (auto &datum : data) {
+        rebuilt.push(&datum);
+    }
+    for (auto &datum : data) {
+        datum = 2 * datum + 1;  // NOLINT: change every priority
+    }
+    rebuilt.updatePriorities();
+    popped.clear();
+    while (!rebuilt.empty()) {
+        popped.push_back((*rebuilt.top() - 1) / 2);
+        rebuilt.pop();
+    }
+    assert(popped == expected);
+
+    std::cout << "testParallel succeeded!" << std::endl;
+}
+
+
+// Test the operation counters, which only count when built with -DPQ_STATS
+// (make stats).
+template <template <typename...> typename PQ>
+void testStats() {
+    std::cout << "Testing operation counters..." << std::endl;
+
+    PQ<int> pq {};
+    pq.push(3);
+    pq.push(4);  // NOLINT: arbitrary value
+    pq.push(1);
+    pq.pop();
+    pq.updatePriorities();
+    assert(pq.top() == 3);
+
+    PQStats stats = pq.stats();
+#ifdef PQ_STATS
+    assert(stats.compares > 0);
+    assert(stats.copies >= 3);
+    assert(stats.updates == 1);
+
+    // Copies and moves carry the counts along with the elements.
+    PQ<int> copied { pq };
+    PQ<int> moved { std::move(copied) };
+    assert(moved.stats().updates == 1);
+    PQ<int> assigned {};
+    assigned = moved;
+    assert(assigned.stats().updates == 1);
+    PQ<int> move_assigned {};
+    move_assigned = std::move(assigned);
+    assert(move_assigned.stats().updates == 1);
+
+    pq.resetStats();
+    assert(pq.stats().compares == 0);
+#else
+    assert(stats.compares == 0);
+    assert(stats.copies == 0);
+    (void)stats;
+#endif
+
+    std::cout << "testStats succeeded!" << std::endl;
+}
+
+
+// Test latency recording and Chrome trace output around a PQ.
+template <template <typename...> typename PQ>
+void testTraced() {
+    std::cout << "Testing latency tracing..." << std::endl;
+
+    const char *path = "testTraced.json";
+    TracedPQ<PQ<int>> pq {};
+    pq.setSampling(1);
+    {
+        ChromeTraceWriter writer { path };
+        pq.setTraceSink(&writer);
+        pq.push(3);
+        pq.push(4);  // NOLINT: arbitrary value
+        pq.updatePriorities();
+        assert(pq.top() == 4);
+        pq.pop();
+        pq.setTraceSink(nullptr);
+    }
+    assert(pq.histogram(PQOp::Push).count() == 2);
+    assert(pq.histogram(PQOp::Pop).count() == 1);
+    assert(pq.histogram(PQOp::UpdatePriorities).count() == 1);
+    assert(pq.histogram(PQOp::Top).percentile(1.0) == pq.histogram(PQOp::Top).max());
+
+    std::ifstream trace { path };
+    std::string json { std::istreambuf_iterator<char> { trace }, std::istreambuf_iterator<char> {} };
+    assert(json.find("{\"traceEvents\":[") == 0);
+    assert(json.find("\"name\":\"updatePriorities\"") != std::string::npos);
+    assert(json.rfind("]}\n") == json.size() - 3);
+    std::remove(path);
+
+    // Sampling times only one operation in N.
+    pq.setSampling(4);  // NOLINT: arbitrary rate
+    for (int i = 0; i < 8; ++i) {  // NOLINT: two samples' worth
+        pq.push(i);
+    }
+    assert(pq.histogram(PQOp::Push).count() == 4);
+
+    std::cout << "testTraced succeeded!" << std::endl;
+}
+
+
+// Check that events were popped highest key first, and equal keys by
+// increasing id.
+bool isStableOrder(const std::vector<Event> &popped) {
+    for (size_t i = 1; i < popped.size(); ++i) {
+        const Event &a = popped[i - 1];
+        const Event &b = popped[i];
+        if (a.key < b.key || (a.key == b.key && a.id > b.id)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+
+// Test that stable mode pops equal elements in the order they were pushed,
+// through interleaved pops, updatePriorities() and running out of
+// insertion numbers.
+template <template <typename...> typename PQ>
+void testStable() {
+    std::cout << "Testing stable ordering..." << std::endl;
+
+    PQ<Event, EventComp> pq {};
+    pq.setStable(true);
+    std::vector<Event> popped;
+    int id = 0;
+    for (int i = 0; i < 300; ++i) {  // NOLINT: arbitrary size
+        pq.push({ (i * 37) % 5, id++ });  // NOLINT: five keys, scrambled
+        if (i % 7 == 6) {  // NOLINT: pop now and then
+            pq.pop();
+        }
+    }
+    while (!pq.empty()) {
+        popped.push_back(pq.top());
+        pq.pop();
+    }
+    assert(popped.size() == 300 - 300 / 7);  // NOLINT: pushes less pops
+    assert(isStableOrder(popped));
+
+    // Ties formed by changed priorities go to the element pushed first.
+    std::vector<Event> events;
+    for (int i = 0; i < 200; ++i) {  // NOLINT: arbitrary size
+        events.push_back({ i, i });
+    }
+    PQ<const Event *, EventPtrComp> pointers {};
+    pointers.setStable(true);
+    for (auto &event : events) {
+        pointers.push(&event);
+    }
+    for (auto &event : events) {
+        event.key %= 3;  // NOLINT: three keys
+    }
+    pointers.updatePriorities();
+    popped.clear();
+    while (!pointers.empty()) {
+        popped.push_back(*pointers.top());
+        pointers.pop();
+    }
+    assert(popped.size() == events.size());
+    assert(isStableOrder(popped));
+
+    // Elements already stored when stable mode starts come before ties
+    // pushed afterwards.
+    PQ<Event, EventComp> late {};
+    late.push({ 1, -1 });
+    late.setStable(true);
+    late.push({ 1, 0 });
+    late.push({ 1, 1 });
+    popped.clear();
+    while (!late.empty()) {
+        popped.push_back(late.top());
+        late.pop();
+    }
+    assert(popped.size() == 3 && isStableOrder(popped));
+
+    // With a tiny limit the PQ renumbers its live elements many times, and
+    // each key still leaves in push order across every renumbering.
+    PQ<Event, EventComp> renumbered {};
+    renumbered.setStable(true, 16);  // NOLINT: tiny limit
+    popped.clear();
+    id = 0;
+    for (int i = 0; i < 200; ++i) {  // NOLINT: arbitrary size
+        renumbered.push({ (i * 37) % 3, id++ });  // NOLINT: three keys, scrambled
+        if (i % 3 == 2) {  // NOLINT: keep a few live elements
+            popped.push_back(renumbered.top());
+            renumbered.pop();
+        }
+    }
+    renumbered.updatePriorities();  // Reorders by number, for SortedPQ
+    while (!renumbered.empty()) {
+        popped.push_back(renumbered.top());
+        renumbered.pop();
+    }
+    assert(popped.size() == 200);  // NOLINT: every push
+    std::array<int, 3> lastId { -1, -1, -1 };
+    for (const Event &event : popped) {
+        auto key = static_cast<size_t>(event.key);
+        assert(event.id > lastId[key]);
+        lastId[key] = event.id;
+    }
+
+    // Running out of numbers renumbers the live ones in the same order.
+    InsertionOrder order { 4 };  // NOLINT: tiny limit
+    order.enable(true);
+    std::vector<InsertionOrder::Sequence> numbers;
+    while (!order.exhausted()) {
+        numbers.push_back(order.stamp());
+    }
+    numbers.erase(numbers.begin());
+    std::vector<InsertionOrder::Sequence *> live;
+    for (auto &number : numbers) {
+        live.push_back(&number);
+    }
+    order.renumber(live);
+    assert(!order.exhausted());
+    numbers.push_back(order.stamp());
+    assert((numbers == std::vector<InsertionOrder::Sequence> { 0, 1, 2, 3 }));
+
+    std::cout << "testStable succeeded!" << std::endl;
+}
+
+
+// Test by_key comparators against the equivalent hand-written ones: the
+// same elements must come out in the same order, ties included, whether
+// or not PQ scans the keys directly.
+template <template <typename...> typename PQ>
+void testByKey() {
+    std::cout << "Testing by_key comparators..." << std::endl;
+
+    static_assert(std::is_empty<max_by_key<&Event::key>>::value, "stateless key comparison takes no space");
+    static_assert(kIsProjection<min_by_key<&Event::key>> && !kIsProjection<EventComp>);
+    static_assert(kCanScanKeys<by_key<&Event::key, std::greater<int>>>);
+    static_assert(!kCanScanKeys<by_key<&Event::key, std::function<bool(int, int)>>>);
+
+    // Least key first, written out by hand.
+    struct EventCompMin {
+        bool operator()(const Event &a, const Event &b) const { return a.key > b.key; }
+    };
+
+    std::vector<Event> events;
+    for (int i = 0; i < 300; ++i) {  // NOLINT: arbitrary size
+        events.push_back({ (i * 37) % 41, i });  // NOLINT: scrambled keys with ties
+    }
+    auto popAll = [](auto pq) {
+        std::vector<int> ids;
+        while (!pq.empty()) {
+            ids.push_back(pq.top().id);
+            pq.pop();
+        }
+        return ids;
+    };
+    const auto maxIds = popAll(PQ<Event, max_by_key<&Event::key>> { events.cbegin(), events.cend() });
+    const auto minIds = popAll(PQ<Event, min_by_key<&Event::key>> { events.cbegin(), events.cend() });
+    assert(maxIds == popAll(PQ<Event, EventComp> { events.cbegin(), events.cend() }));
+    assert(minIds == popAll(PQ<Event, EventCompMin> { events.cbegin(), events.cend() }));
+    assert(events[static_cast<size_t>(minIds.front())].key == 0);
+    (void)maxIds;
+    (void)minIds;
+
+    // A key comparison with state is kept and used.
+    using Dynamic = by_key<&Event::key, std::function<bool(int, int)>>;
+    PQ<Event, Dynamic> dynamic { Dynamic { [](int a, int b) { return a > b; } } };
+    for (const Event &event : events) {
+        dynamic.push(event);
+    }
+    assert(dynamic.top().key == 0);
+
+    std::cout << "testByKey succeeded!" << std::endl;
+}
+
+
 // Test the pairing heap's range-based constructor, copy constructor,
 // copy-assignment operator, and destructor
 // TODO: Test other operations specific to this PQ type.
@@ -194,7 +657,30 @@ void testPairing() {
 
         std::cout << "Basic tests done." << std::endl;
 
-        // TODO: Add more code to test addNode, updateElt, etc.
+        // addNode returns handles whose priority can be raised later.
+        PairingPQ<int> pairing4 { vec.cbegin(), vec.cend() };
+        auto *node5 = pairing4.addNode(5);  // NOLINT: arbitrary value
+        auto *node2 = pairing4.addNode(2);
+        assert(pairing4.top() == 5);
+        pairing4.updateElt(node2, 7);  // NOLINT: above everything else
+        assert(pairing4.top() == 7);
+        assert(**node2 == 7);
+        pairing4.updateElt(node5, 6);  // NOLINT: raise a non-root node
+        pairing4.pop();
+        assert(pairing4.top() == 6);
+        assert(pairing4.size() == 3);
+
+        // updateElt is timed too when the heap is traced.
+        TracedPQ<PairingPQ<int>> traced { vec.cbegin(), vec.cend() };
+        traced.setSampling(1);
+        traced.updateElt(traced.addNode(-1), 2);
+        assert(traced.top() == 2);
+        assert(traced.histogram(PQOp::UpdateElt).count() == 1);
+
+        // Moving hands the nodes over instead of sharing them.
+        PairingPQ<int> pairing5 { std::move(pairing4) };
+        assert(pairing5.size() == 3);
+        assert(pairing5.top() == 6);
 
         // That { above creates a scope, and our pairing heaps will fall out
         // of scope at the matching } below.
@@ -205,12 +691,1169 @@ void testPairing() {
 }
 
 
+// Test the sorted PQ's read-only iteration and range queries.
+// Test the hollow heap's constructors and its handles, checking a long run
+// of updateElt() calls and pops against a sorted copy.
+void testHollow() {
+    std::cout << "Testing Hollow Heap separately..." << std::endl;
+
+    const std::vector<int> vec { 1, 0 };
+    HollowPQ<int> hollow1 { vec.cbegin(), vec.cend() };
+    HollowPQ<int> hollow2 { hollow1 };
+    HollowPQ<int> hollow3 {};
+    hollow3 = hollow2;
+    hollow1.push(3);
+    hollow2.pop();
+    assert(hollow1.size() == 3);
+    assert(hollow1.top() == 3);
+    assert(hollow2.top() == 0);
+    assert(hollow3.top() == 1);
+
+    auto *node5 = hollow1.addNode(5);  // NOLINT: arbitrary value
+    auto *node2 = hollow1.addNode(2);
+    hollow1.updateElt(node2, 7);  // NOLINT: above everything else
+    assert(hollow1.top() == 7);
+    assert(**node2 == 7);
+    hollow1.updateElt(node5, 6);  // NOLINT: raise a non-root node
+    hollow1.pop();
+    assert(hollow1.top() == 6);
+    assert(hollow1.size() == 4);
+
+    HollowPQ<int> hollow4 { std::move(hollow1) };
+    assert(hollow4.size() == 4);
+    assert(hollow4.top() == 6);
+
+    // Raise random elements between pops, keeping the expected contents in
+    // a plain vector alongside.
+    HollowPQ<int> heap {};
+    std::vector<HollowPQ<int>::Node *> nodes;
+    std::vector<int> values;
+    for (int i = 0; i < 2000; ++i) {  // NOLINT: arbitrary size
+        values.push_back((i * 7919) % 10007);  // NOLINT: scrambled order
+        nodes.push_back(heap.addNode(values.back()));
+    }
+    std::vector<int> popped;
+    std::vector<int> expected;
+    for (int round = 0; round < 1500; ++round) {  // NOLINT: leaves some behind
+        for (int i = 0; i < 3; ++i) {  // NOLINT: a few raises per pop
+            auto pick = static_cast<size_t>(round * 31 + i * 17) % nodes.size();  // NOLINT: arbitrary
+            values[pick] += (round % 5) + 1;  // NOLINT: arbitrary raise
+            heap.updateElt(nodes[pick], values[pick]);
+        }
+        if (round == 700) {  // NOLINT: rebuild once, halfway
+            heap.updatePriorities();
+        }
+        expected.push_back(*std::max_element(values.begin(), values.end()));
+        popped.push_back(heap.top());
+        // Equal values are interchangeable, so drop whichever node is on top.
+        auto index = static_cast<size_t>(
+            std::find_if(nodes.begin(), nodes.end(), [&heap](auto *node) { return &node->getElt() == &heap.top(); })
+            - nodes.begin());
+        nodes.erase(nodes.begin() + static_cast<std::ptrdiff_t>(index));
+        values.erase(values.begin() + static_cast<std::ptrdiff_t>(index));
+        heap.pop();
+    }
+    assert(popped == expected);
+    assert(heap.size() == nodes.size());
+    assert(std::equal(nodes.begin(), nodes.end(), values.begin(), [](auto *node, int value) { return **node == value; }));
+
+    // A copy leaves the hollow cells behind but keeps every element.
+    HollowPQ<int> copy { heap };
+    std::sort(values.rbegin(), values.rend());
+    popped.clear();
+    while (!copy.empty()) {
+        popped.push_back(copy.top());
+        copy.pop();
+    }
+    assert(popped == values);
+
+    std::cout << "testHollow succeeded!" << std::endl;
+}
+
+
+// Test the decrease-key path as Dijkstra's algorithm uses it: raise the
+// priority of queued vertices through updateElt() as shorter paths turn
+// up, and check the distances against Bellman-Ford.
+template <template <typename...> typename PQ>
+void testShortestPaths() {
+    std::cout << "Testing shortest paths with updateElt()..." << std::endl;
+
+    struct Edge {
+        size_t from, to;
+        int weight;
+    };
+    // Closer vertices have higher priority.
+    struct Closer {
+        bool operator()(const std::pair<int, size_t> &a, const std::pair<int, size_t> &b) const {
+            return a.first > b.first;
+        }
+    };
+
+    const size_t n = 60;  // NOLINT: arbitrary size
+    std::mt19937 rng { 281 };  // NOLINT: fixed seed
+    std::vector<Edge> edges;
+    for (size_t i = 0; i < 6 * n; ++i) {  // NOLINT: arbitrary degree
+        edges.push_back({ rng() % n, rng() % n, static_cast<int>(rng() % 20) });  // NOLINT: weights 0-19
+    }
+
+    const int unreached = std::numeric_limits<int>::max();
+    std::vector<int> expected(n, unreached);
+    expected[0] = 0;
+    for (size_t round = 1; round < n; ++round) {
+        for (const Edge &edge : edges) {
+            if (expected[edge.from] != unreached) {
+                expected[edge.to] = std::min(expected[edge.to], expected[edge.from] + edge.weight);
+            }
+        }
+    }
+
+    using Heap = PQ<std::pair<int, size_t>, Closer>;
+    Heap heap {};
+    std::vector<int> dist(n, unreached);
+    std::vector<typename Heap::Node *> nodes(n, nullptr);
+    size_t decreases = 0;
+    dist[0] = 0;
+    nodes[0] = heap.addNode({ 0, 0 });
+    while (!heap.empty()) {
+        size_t from = heap.top().second;
+        heap.pop();
+        nodes[from] = nullptr;
+        for (const Edge &edge : edges) {
+            if (edge.from != from || dist[from] + edge.weight >= dist[edge.to]) {
+                continue;
+            }
+            dist[edge.to] = dist[from] + edge.weight;
+            if (nodes[edge.to]) {
+                heap.updateElt(nodes[edge.to], { dist[edge.to], edge.to });
+                ++decreases;
+            } else {
+                nodes[edge.to] = heap.addNode({ dist[edge.to], edge.to });
+            }
+        }
+    }
+    assert(dist == expected);
+    assert(decreases > 0);
+    (void)decreases;
+
+    std::cout << "testShortestPaths succeeded!" << std::endl;
+}
+
+
+// Test that versions of a persistent PQ are independent: branching off a
+// copy, or through pushed(), popped() and merged(), leaves the original as
+// it was.
+void testPersistent() {
+    std::cout << "Testing PersistentPQ separately..." << std::endl;
+
+    const std::vector<int> vec { 5, 1, 8, 3 };  // NOLINT: arbitrary values
+    const PersistentPQ<int> base { vec.cbegin(), vec.cend() };
+
+    PersistentPQ<int> branch { base };
+    assert(branch.shares(base));
+    branch.push(10);  // NOLINT: above everything else
+    branch.pop();
+    branch.pop();
+    assert(!branch.shares(base));
+    assert(branch.top() == 5 && branch.size() == 3);
+    assert(base.top() == 8 && base.size() == 4);
+
+    PersistentPQ<int> left = base.popped().pushed(2);
+    PersistentPQ<int> right = base.pushed(9);  // NOLINT: arbitrary value
+    PersistentPQ<int> both = left.merged(right);
+    assert(base.top() == 8 && base.size() == 4);
+    assert(left.top() == 5 && left.size() == 4);
+    assert(right.top() == 9 && right.size() == 5);
+
+    std::vector<int> popped;
+    while (!both.empty()) {
+        popped.push_back(both.top());
+        both.pop();
+    }
+    assert((popped == std::vector<int> { 9, 8, 5, 5, 3, 3, 2, 1, 1 }));  // NOLINT: both merged
+    assert(left.size() == 4 && right.size() == 5);
+
+    // Pushing rising values builds a long left spine; freeing it must not
+    // recurse once per node.
+    PersistentPQ<int> spine {};
+    for (int i = 0; i < 200000; ++i) {  // NOLINT: deep enough to overflow a recursive free
+        spine.push(i);
+    }
+    PersistentPQ<int> shared { spine };
+    spine = PersistentPQ<int> {};
+    assert(shared.top() == 199999 && shared.size() == 200000);  // NOLINT: as pushed
+
+    std::cout << "testPersistent succeeded!" << std::endl;
+}
+
+
+// Test that popBatch() returns the k most extreme elements in order, on
+// one thread and several, and however unevenly the shards are filled.
+void testBatch() {
+    std::cout << "Testing BatchPQ separately..." << std::endl;
+
+    ParallelOptions threads;
+    threads.threads = 3;   // NOLINT: uneven split on purpose
+    threads.min_size = 0;  // Always use threads
+
+    std::mt19937 rng { 281 };  // NOLINT: fixed seed
+    for (auto options : { ParallelOptions {}, threads }) {
+        BatchPQ<int> pq { std::less<int> {}, options };
+        assert(pq.shardCount() == options.threads);
+        std::multiset<int, std::greater<int>> reference;
+
+        std::vector<int> batch;
+        for (int i = 0; i < 1000; ++i) {  // NOLINT: arbitrary size
+            batch.push_back(static_cast<int>(rng() % 300));  // NOLINT: plenty of duplicates
+        }
+        pq.pushBatch(batch.begin(), batch.end());
+        reference.insert(batch.begin(), batch.end());
+        assert(pq.size() == reference.size());
+
+        for (std::size_t k : { 0, 1, 2, 3, 7, 50, 200 }) {  // NOLINT: around and above the shard count
+            std::vector<int> popped;
+            pq.popBatch(k, std::back_inserter(popped));
+            assert(popped.size() == k);
+            assert(std::equal(popped.begin(), popped.end(), reference.begin()));
+            reference.erase(reference.begin(), std::next(reference.begin(), static_cast<std::ptrdiff_t>(k)));
+            assert(pq.size() == reference.size());
+            assert(pq.top() == *reference.begin());
+        }
+
+        // Every third element is large, so with three shards one shard
+        // holds all of the top of the PQ and its quota must grow.
+        batch.clear();
+        for (int i = 0; i < 90; ++i) {  // NOLINT: arbitrary size
+            batch.push_back(i % 3 == 0 ? 1000 + i : i);  // NOLINT: above everything else
+        }
+        pq.pushBatch(batch.begin(), batch.end());
+        reference.insert(batch.begin(), batch.end());
+        std::vector<int> large;
+        pq.popBatch(30, std::back_inserter(large));  // NOLINT: all of the large ones
+        assert(std::equal(large.begin(), large.end(), reference.begin()));
+        reference.erase(reference.begin(), std::next(reference.begin(), 30));  // NOLINT: as popped
+        assert(pq.top() == *reference.begin());
+        pq.pop();
+        reference.erase(reference.begin());
+
+        std::vector<int> rest;
+        pq.popBatch(pq.size() + 10, std::back_inserter(rest));  // NOLINT: more than there are
+        assert(pq.empty());
+        assert(std::equal(rest.begin(), rest.end(), reference.begin(), reference.end()));
+    }
+
+    // Resharding keeps every element.
+    std::vector<int> vec { 5, 1, 8, 3, 9, 2 };  // NOLINT: arbitrary values
+    BatchPQ<int> resharded { vec.begin(), vec.end() };
+    resharded.setParallelism(threads);
+    assert(resharded.shardCount() == 3 && resharded.size() == vec.size());
+    std::vector<int> sorted;
+    resharded.popBatch(vec.size(), std::back_inserter(sorted));
+    assert((sorted == std::vector<int> { 9, 8, 5, 3, 2, 1 }));  // NOLINT: descending
+
+    // Elements that are not trivially copyable can be resharded, and a copy
+    // runs its batches on threads of its own, also after the number of
+    // threads changes.
+    std::vector<std::string> words { "pear", "fig", "apple", "kiwi", "plum" };
+    BatchPQ<std::string> strings { words.begin(), words.end(), std::less<std::string> {}, threads };
+    strings.pushBatch(words.begin(), words.end());
+    BatchPQ<std::string> copy { strings };
+    threads.threads = 2;
+    strings.setParallelism(threads);
+    assert(strings.shardCount() == 2 && strings.size() == 2 * words.size());
+    std::vector<std::string> fromOriginal;
+    std::vector<std::string> fromCopy;
+    strings.popBatch(4, std::back_inserter(fromOriginal));  // NOLINT: both plums and both pears
+    copy.popBatch(4, std::back_inserter(fromCopy));  // NOLINT: the same
+    assert((fromOriginal == std::vector<std::string> { "plum", "plum", "pear", "pear" }));
+    assert(fromCopy == fromOriginal && copy.size() == strings.size());
+
+    std::cout << "testBatch succeeded!" << std::endl;
+}
+
+
+// Test that SmallPQ stays inline up to its capacity, spills past it, and
+// goes back inline once empty.
+void testSmall() {
+    std::cout << "Testing Small PQ separately..." << std::endl;
+
+    SmallPQ<int> pq {};
+    const std::vector<int> vec { 5, 1, 8, 3, 9, 2, 7, 4 };  // NOLINT: arbitrary values
+    static_assert(SmallPQ<int>::kInlineCapacity == 8, "default capacity");
+    for (int value : vec) {
+        pq.push(value);
+    }
+    assert(pq.isInline());
+    assert(pq.top() == 9);
+    SmallPQ<int> inlineCopy { pq };
+
+    pq.push(6);  // NOLINT: one past the capacity
+    assert(!pq.isInline());
+    SmallPQ<int> spilledCopy { pq };
+
+    std::vector<int> popped;
+    while (!pq.empty()) {
+        popped.push_back(pq.top());
+        pq.pop();
+    }
+    assert((popped == std::vector<int> { 9, 8, 7, 6, 5, 4, 3, 2, 1 }));
+    assert(pq.isInline());
+    pq.push(3);
+    assert(pq.isInline() && pq.top() == 3);
+
+    assert(inlineCopy.isInline() && inlineCopy.size() == vec.size());
+    assert(!spilledCopy.isInline() && spilledCopy.size() == vec.size() + 1);
+
+    // The range constructor spills when the range is too long.
+    std::vector<int> many { vec };
+    many.insert(many.end(), vec.begin(), vec.end());
+    SmallPQ<int> ranged { many.cbegin(), many.cend() };
+    assert(!ranged.isInline() && ranged.top() == 9);
+    SmallPQ<int> shortRanged { vec.cbegin(), vec.cbegin() + 3 };
+    assert(shortRanged.isInline() && shortRanged.top() == 8);
+
+    std::cout << "testSmall succeeded!" << std::endl;
+}
+
+
+void testSorted() {
+    std::cout << "Testing Sorted PQ separately..." << std::endl;
+
+    const std::vector<int> vec { 4, 9, 1, 7, 3, 9, 5 };
+    SortedPQ<int> sorted { vec.cbegin(), vec.cend() };
+
+    // Iteration yields the elements least extreme first, without draining.
+    const std::vector<int> snapshot { sorted.begin(), sorted.end() };
+    assert((snapshot == std::vector<int> { 1, 3, 4, 5, 7, 9, 9 }));
+    assert(sorted.size() == vec.size());
+
+    assert(sorted.count_above(5) == 3);
+    assert(sorted.count_above(9) == 0);
+    assert(sorted.count_above(0) == vec.size());
+    assert(*sorted.lower_bound(6) == 7);
+    assert(sorted.lower_bound(10) == sorted.end());
+
+    // Remove the whole prefix above a threshold in one call.
+    assert(sorted.pop_while([](int x) { return x > 4; }) == 4);
+    assert(sorted.size() == 3);
+    assert(sorted.top() == 4);
+    assert(sorted.pop_while([](int x) { return x > 100; }) == 0);
+    assert(sorted.pop_while([](int) { return true; }) == 3);
+    assert(sorted.empty());
+
+    std::cout << "testSorted succeeded!" << std::endl;
+}
+
+
+// Test that an array-based PQ allocates through the allocator it is given,
+// that reserve() makes room in advance, and that shrink_to_fit() gives the
+// room back.
+template <template <typename...> typename PQ>
+void testAllocator() {
+    std::cout << "Testing allocators..." << std::endl;
+
+    std::size_t allocations = 0;
+    using CountingPQ = PQ<int, std::less<int>, CountingAllocator<int>>;
+    CountingPQ pq { std::less<int> {}, CountingAllocator<int> { &allocations } };
+    pq.reserve(100);  // NOLINT: arbitrary size
+    assert(pq.capacity() >= 100);
+    const std::size_t reserved = allocations;
+    for (int i = 0; i < 100; ++i) {  // NOLINT: as many as reserved
+        pq.push(i * 37 % 100);  // NOLINT: a permutation of 0-99
+    }
+    assert(allocations == reserved);
+    assert(pq.top() == 99);
+
+    CountingPQ copy { pq };
+    assert(copy.get_allocator() == pq.get_allocator());
+    assert(allocations > reserved);
+    (void)reserved;
+
+    while (!pq.empty()) {
+        pq.pop();
+    }
+    pq.shrink_to_fit();
+    assert(pq.capacity() == 0);
+    pq.push(1);
+    assert(pq.top() == 1 && copy.top() == 99);
+
+    // Every allocation comes out of the buffer; the null upstream resource
+    // throws if it runs out.
+    std::array<std::byte, 16384> buffer {};  // NOLINT: room for a few vectors of 1000 ints
+    std::pmr::monotonic_buffer_resource arena { buffer.data(), buffer.size(), std::pmr::null_memory_resource() };
+    PQ<int, std::less<int>, std::pmr::polymorphic_allocator<int>> pmr { std::less<int> {}, &arena };
+    pmr.reserve(1000);  // NOLINT: arbitrary size
+    for (int i = 0; i < 1000; ++i) {  // NOLINT: as many as reserved
+        pmr.push(i * 37 % 1000);  // NOLINT: a permutation of 0-999
+    }
+    assert(pmr.get_allocator().resource() == &arena);
+    std::vector<int> popped;
+    while (!pmr.empty()) {
+        popped.push_back(pmr.top());
+        pmr.pop();
+    }
+    assert(popped.size() == 1000 && std::is_sorted(popped.rbegin(), popped.rend()));
+
+    std::cout << "testAllocator succeeded!" << std::endl;
+}
+
+
+// Test that HugePageResource maps large allocations, falls back when no
+// huge pages are reserved, and passes small ones upstream.
+void testHugePages() {
+    std::cout << "Testing huge page storage..." << std::endl;
+
+    HugePageOptions options;
+    options.pages = HugePages::Explicit;
+    options.numa = NumaPlacement::Interleave;
+    options.min_bytes = 4096;  // NOLINT: map even a small test heap
+    HugePageResource pages { options };
+    PmrBinaryPQ<int> pq { std::less<int> {}, &pages };
+    pq.reserve(100000);  // NOLINT: arbitrary size
+    for (int i = 0; i < 100000; ++i) {  // NOLINT: as many as reserved
+        pq.push(i * 37 % 100000);  // NOLINT: a permutation of 0-99999
+    }
+    assert(pages.mappings() >= 1);
+    assert(pages.fallbacks() <= pages.mappings());
+    for (int i = 99999; i >= 0; --i) {  // NOLINT: descending
+        assert(pq.top() == i);
+        pq.pop();
+    }
+
+    // Mappings not from the reserved pool start on a huge page boundary.
+    options.pages = HugePages::Transparent;
+    options.numa = NumaPlacement::Bind;
+    HugePageResource bound { options };
+    void *block = bound.allocate(3 * HugePageResource::kHugePageSize / 2);
+    assert(reinterpret_cast<std::uintptr_t>(block) % HugePageResource::kHugePageSize == 0);
+    static_cast<int *>(block)[0] = 1;
+    bound.deallocate(block, 3 * HugePageResource::kHugePageSize / 2);
+
+    // Small allocations go upstream at the default threshold.
+    HugePageResource defaults {};
+    PmrBinaryPQ<int> small { std::less<int> {}, &defaults };
+    small.push(1);
+    assert(defaults.mappings() == 0);
+
+    bool threw = false;
+    try {
+        options.node = 64;  // NOLINT: past the supported nodes
+        HugePageResource nowhere { options };
+    } catch (const std::invalid_argument &) {
+        threw = true;
+    }
+    assert(threw);
+    (void)threw;
+
+    std::cout << "testHugePages succeeded!" << std::endl;
+}
+
+
+// Test lazy erasure through handles, for the PQs that support it.
+template <template <typename...> typename PQ>
+void testTombstones() {
+    std::cout << "Testing lazy erase..." << std::endl;
+
+    PQ<int> pq {};
+    pq.push(2);  // pushed before tracking starts
+    pq.pushHandle(8);
+    auto h5 = pq.pushHandle(5);
+    auto h9 = pq.pushHandle(9);
+    pq.setCompactionThreshold(0.9);  // NOLINT: keep tombstones around for now
+
+    // Erasing the top exposes the next live element.
+    pq.erase(h9);
+    assert(pq.size() == 3);
+    assert(pq.top() == 8);
+
+    // Erasing twice is harmless; the dead element is skipped on pop.
+    pq.erase(h5);
+    pq.erase(h5);
+    assert(pq.size() == 2);
+    pq.pop();
+    assert(pq.top() == 2);
+    assert(pq.size() == 1);
+
+    // Crossing the threshold discards every tombstone at once.
+    for (int i = 0; i < 4; ++i) {
+        pq.push(i);
+    }
+    auto h7 = pq.pushHandle(7);
+    pq.setCompactionThreshold(0.1);  // NOLINT: compact on the next erase
+    pq.erase(h7);
+    assert(pq.tombstoneCount() == 0);
+    assert(pq.tombstoneRatio() == 0.0);
+    assert(pq.size() == 5);
+    assert(pq.top() == 3);
+
+    // Handles are recycled, and a fresh handle is live.
+    auto h6 = pq.pushHandle(6);
+    assert(pq.top() == 6);
+    pq.erase(h6);
+    assert(pq.top() == 3);
+
+    while (!pq.empty()) {
+        pq.pop();
+    }
+
+    std::cout << "testTombstones succeeded!" << std::endl;
+}
+
+
+// Test that the file-backed binary heap keeps its contents across reopening.
+void testMappedBinary() {
+    std::cout << "Testing file-backed binary heap..." << std::endl;
+
+    const char *path = "testMappedBinary.pq";
+    std::remove(path);
+
+    {
+        MappedBinaryPQ<int> mapped { path };
+        // Enough pushes to grow the file past its initial capacity.
+        for (int i = 0; i < 3000; ++i) {  // NOLINT: arbitrary size
+            mapped.push((i * 7919) % 3001);  // NOLINT: scrambled order
+        }
+        mapped.pop();
+        assert(mapped.size() == 2999);
+    }
+
+    {
+        MappedBinaryPQ<int> reopened { path, std::less<int> {}, SyncPolicy::EveryOp };
+        assert(reopened.size() == 2999);
+        assert(reopened.isHeap());
+        std::vector<int> popped;
+        while (!reopened.empty()) {
+            popped.push_back(reopened.top());
+            reopened.pop();
+        }
+        assert(std::is_sorted(popped.rbegin(), popped.rend()));
+    }
+
+    // A file too short for the header, or holding another TYPE, is refused.
+    auto refused = [path] {
+        try {
+            MappedBinaryPQ<double> wrong { path };
+        } catch (const std::runtime_error &) {
+            return true;
+        }
+        return false;
+    };
+    {
+        std::ofstream shortFile { path, std::ios::binary | std::ios::trunc };
+        shortFile << "not a heap";
+    }
+    bool shortRefused = refused();
+    assert(shortRefused);
+    std::remove(path);
+    MappedBinaryPQ<int> { path }.push(1);
+    bool wrongTypeRefused = refused();
+    assert(wrongTypeRefused);
+    (void)shortRefused;
+    (void)wrongTypeRefused;
+
+    std::remove(path);
+    std::cout << "testMappedBinary succeeded!" << std::endl;
+}
+
+
+// Run body in a child process. The child leaves with _exit(), skipping the
+// parent's destructors, with status 0 if body returned true.
+template <typename Body>
+pid_t spawn(Body body) {
+    pid_t pid = fork();
+    if (pid == 0) {
+        _exit(body() ? 0 : 1);
+    }
+    return pid;
+}
+
+// Wait for every child and return true if all of them succeeded.
+bool reapAll(const std::vector<pid_t> &children) {
+    bool succeeded = true;
+    for (pid_t child : children) {
+        int status = 0;
+        succeeded &= child > 0 && waitpid(child, &status, 0) == child && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+    }
+    return succeeded;
+}
+
+
+// Test a heap shared between processes: several producers push at once,
+// then several consumers pop at once, passing what they pop on to a second
+// shared heap so that the parent can check nothing was lost or duplicated.
+void testSharedBinary() {
+    std::cout << "Testing shared-memory binary heap..." << std::endl;
+
+    const std::string jobsName = "/pq281-test-" + std::to_string(getpid());
+    const std::string doneName = jobsName + "-done";
+    SharedBinaryPQ<int>::remove(jobsName);
+    SharedBinaryPQ<int>::remove(doneName);
+    const int workers = 4;
+    const int perWorker = 1000;  // NOLINT: arbitrary size
+    const int total = workers * perWorker;
+
+    {
+        SharedBinaryPQ<int> jobs { jobsName, static_cast<std::size_t>(total) };
+        SharedBinaryPQ<int> done { doneName, static_cast<std::size_t>(total) };
+        assert(jobs.capacity() == static_cast<std::size_t>(total) && jobs.empty());
+
+        // Each producer opens the heap by name, as an unrelated process would.
+        std::vector<pid_t> children;
+        for (int w = 0; w < workers; ++w) {
+            children.push_back(spawn([&jobsName, w] {
+                SharedBinaryPQ<int> queue { jobsName };
+                for (int i = 0; i < perWorker; ++i) {
+                    queue.push(w + workers * ((i * 7919) % perWorker));  // NOLINT: scrambled order
+                }
+                return true;
+            }));
+        }
+        assert(reapAll(children));
+        assert(jobs.size() == static_cast<std::size_t>(total));
+        assert(jobs.isHeap() && jobs.top() == total - 1);
+
+        // Each consumer sees its own pops in priority order.
+        children.clear();
+        for (int w = 0; w < workers; ++w) {
+            children.push_back(spawn([&jobsName, &doneName] {
+                SharedBinaryPQ<int> queue { jobsName };
+                SharedBinaryPQ<int> finished { doneName };
+                int job = 0;
+                int previous = total;
+                bool inOrder = true;
+                while (queue.tryPop(job)) {
+                    inOrder &= job < previous;
+                    previous = job;
+                    finished.push(job);
+                }
+                return inOrder;
+            }));
+        }
+        assert(reapAll(children));
+        assert(jobs.empty());
+
+        std::vector<int> popped;
+        int job = 0;
+        while (done.tryPop(job)) {
+            popped.push_back(job);
+        }
+        std::vector<int> expected(static_cast<std::size_t>(total));
+        for (int i = 0; i < total; ++i) {
+            expected[static_cast<std::size_t>(i)] = total - 1 - i;
+        }
+        assert(popped == expected);
+
+        // A full heap refuses more.
+        for (int i = 0; i < total; ++i) {
+            jobs.push(i);
+        }
+        assert(!jobs.tryPush(0));
+        bool threw = false;
+        try {
+            jobs.push(0);
+        } catch (const std::length_error &) {
+            threw = true;
+        }
+        assert(threw);
+        (void)threw;
+    }
+
+    SharedBinaryPQ<int>::remove(jobsName);
+    SharedBinaryPQ<int>::remove(doneName);
+
+    // A segment whose creator died before sizing it, or before marking it
+    // ready, is given up on after the timeout.
+    for (std::size_t size : { std::size_t { 0 }, std::size_t { 4096 } }) {  // NOLINT: one page
+        int fd = ::shm_open(jobsName.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);  // NOLINT: rw-------
+        assert(fd >= 0);
+        int sized = ::ftruncate(fd, static_cast<off_t>(size));
+        assert(sized == 0);
+        (void)sized;
+        ::close(fd);
+        bool threw = false;
+        try {
+            SharedBinaryPQ<int> orphan { jobsName, SharedBinaryPQ<int>::kDefaultCapacity, std::less<int> {},
+                                         std::chrono::milliseconds { 20 } };  // NOLINT: short wait
+        } catch (const std::runtime_error &) {
+            threw = true;
+        }
+        assert(threw);
+        (void)threw;
+        SharedBinaryPQ<int>::remove(jobsName);
+    }
+
+    std::cout << "testSharedBinary succeeded!" << std::endl;
+}
+
+
+#if __cplusplus >= 202002L
+// Wait on pq count times with the given priority, recording what arrives.
+AsyncTask consume(AsyncPQ<BinaryPQ<int>> &pq, int priority, int count, std::vector<int> &received) {
+    for (int i = 0; i < count; ++i) {
+        received.push_back(co_await pq.pop_async(priority));
+    }
+}
+
+
+// Test waiting on an empty PQ with coroutines, with and without an
+// executor. Only built as C++20.
+void testAsync() {
+    std::cout << "Testing coroutine PQ..." << std::endl;
+
+    // Without an executor, push() resumes the waiter before it returns.
+    AsyncPQ<BinaryPQ<int>> direct {};
+    std::vector<int> received;
+    direct.push(4);  // NOLINT: arbitrary value
+    consume(direct, 0, 3, received);
+    assert((received == std::vector<int> { 4 }));
+    assert(direct.waiting() == 1);
+    direct.push(7);  // NOLINT: arbitrary value
+    assert((received == std::vector<int> { 4, 7 }));
+    direct.push(2);
+    assert(direct.waiting() == 0 && direct.empty());
+
+    // With an executor, pushes are batched until it runs, and then the
+    // best waiter gets the best element; equal waiters go in turn.
+    AsyncExecutor executor;
+    AsyncPQ<BinaryPQ<int>> batched { &executor };
+    std::vector<int> low;
+    std::vector<int> high;
+    std::vector<int> firstMid;
+    std::vector<int> secondMid;
+    consume(batched, 1, 1, low);
+    consume(batched, 5, 1, high);  // NOLINT: arbitrary priority
+    consume(batched, 3, 1, firstMid);
+    consume(batched, 3, 1, secondMid);
+    assert(batched.waiting() == 4);
+
+    batched.push(10);  // NOLINT: arbitrary value
+    const std::vector<int> more { 30, 20, 40, 5 };
+    batched.push(more.begin(), more.end());
+    assert(high.empty() && batched.size() == 5);
+    assert(executor.run() == 1);
+    assert((high == std::vector<int> { 40 }));
+    assert((firstMid == std::vector<int> { 30 }));
+    assert((secondMid == std::vector<int> { 20 }));
+    assert((low == std::vector<int> { 10 }));
+    assert(batched.waiting() == 0 && batched.tryPop() == 5);
+    assert(!batched.tryPop());
+
+    std::cout << "testAsync succeeded!" << std::endl;
+}
+#endif
+
+
+// Test the external-memory PQ with a budget so small that it must spill
+// many runs to disk and merge them.
+void testExternal() {
+    std::cout << "Testing External PQ separately..." << std::endl;
+
+    ExternalPQOptions options;
+    options.dir = ".";
+    options.buffer_bytes = 16 * sizeof(int);  // NOLINT: tiny buffer
+    options.block_bytes = 4 * sizeof(int);    // NOLINT: tiny blocks
+    options.max_runs = 4;                     // NOLINT: force merges
+
+    ExternalPQ<int> pq { std::less<int> {}, options };
+    std::vector<int> expected;
+    for (int i = 0; i < 1000; ++i) {  // NOLINT: arbitrary size
+        pq.push((i * 7919) % 1009);   // NOLINT: scrambled order
+        expected.push_back((i * 7919) % 1009);  // NOLINT: same values
+    }
+    assert(pq.size() == expected.size());
+    // 62 spills leave runs at three levels, fewer than max_runs at each,
+    // and every element was written once per level.
+    assert(pq.runCount() > 0);
+    assert(pq.runCount() < 3 * options.max_runs);
+    assert(pq.runWrites() <= 3 * expected.size());
+
+    // Interleave pushes with pops so elements come from both the buffer and
+    // the runs.
+    std::sort(expected.begin(), expected.end());
+    for (int i = 0; i < 100; ++i) {  // NOLINT: arbitrary count
+        assert(pq.top() == expected.back());
+        expected.pop_back();
+        pq.pop();
+        pq.push(i);
+        expected.insert(std::upper_bound(expected.begin(), expected.end(), i), i);
+    }
+
+    pq.updatePriorities();
+    while (!pq.empty()) {
+        assert(pq.top() == expected.back());
+        expected.pop_back();
+        pq.pop();
+    }
+    assert(expected.empty());
+    assert(pq.runCount() == 0);
+
+    std::cout << "testExternal succeeded!" << std::endl;
+}
+
+
+// A timer for TimingWheelPQ: earlier deadlines first, then lower ids.
+struct Timer {
+    std::uint64_t deadline;
+    int id;
+};
+
+struct TimerComp {
+    bool operator()(const Timer &a, const Timer &b) const {
+        return a.deadline != b.deadline ? a.deadline > b.deadline : a.id > b.id;
+    }
+};
+
+struct TimerDeadline {
+    std::uint64_t operator()(const Timer &timer) const { return timer.deadline; }
+};
+
+struct TickPtrComp {
+    bool operator()(const std::uint64_t *a, const std::uint64_t *b) const { return *a > *b; }
+};
+
+struct TickPtrDeadline {
+    std::uint64_t operator()(const std::uint64_t *tick) const { return *tick; }
+};
+
+bool operator<(const Timer &a, const Timer &b) {
+    return TimerComp {}(b, a);
+}
+
+
+// TimingWheelPQ orders by deadline, earliest first, so it does not fit the
+// generic tests, which expect std::less to put the largest element on top.
+void testTimingWheel() {
+    std::cout << "Testing timing wheel..." << std::endl;
+
+    // Deadlines in every level, past the top level, and at the cursor.
+    const std::vector<std::uint64_t> ticks { 5, 70, 3, 5000, 300000, std::uint64_t { 1 } << 30, 64, 4096, 0, 5 };
+    TimingWheelPQ<std::uint64_t> wheel {};
+    Eecs281PQ<std::uint64_t, std::greater<std::uint64_t>> &eecsPQ = wheel;
+    for (auto tick : ticks) {
+        eecsPQ.push(tick);
+    }
+    TimingWheelPQ<std::uint64_t> copy { wheel };
+    std::vector<std::uint64_t> expected { ticks };
+    std::sort(expected.begin(), expected.end());
+    std::vector<std::uint64_t> popped;
+    while (!eecsPQ.empty()) {
+        popped.push_back(eecsPQ.top());
+        eecsPQ.pop();
+    }
+    assert(popped == expected);
+    assert(wheel.now() == std::uint64_t { 1 } << 30);
+    assert(copy.size() == ticks.size() && copy.top() == 0);
+
+    // Cancel at the cursor, in the wheel, and far off; a second cancel and
+    // a cancel after popping both fail.
+    TimingWheelPQ<Timer, TimerComp, TimerDeadline> timers {};
+    const std::vector<TimingWheelPQ<Timer, TimerComp, TimerDeadline>::Handle> scheduled {
+        timers.schedule({ 0, 1 }),
+        timers.schedule({ 100, 2 }),  // NOLINT: arbitrary tick
+        timers.schedule({ 100000, 3 }),  // NOLINT: arbitrary tick
+        timers.schedule({ std::uint64_t { 1 } << 40, 4 }),  // NOLINT: past the wheel
+    };
+    timers.schedule({ 100, 5 });  // NOLINT: arbitrary id
+    std::vector<bool> cancelled { timers.cancel(scheduled[0]), timers.cancel(scheduled[1]),
+                                  timers.cancel(scheduled[3]), timers.cancel(scheduled[1]) };
+    assert(timers.size() == 2 && timers.top().id == 5);
+    timers.pop();
+    assert(timers.top().id == 3);
+    timers.pop();
+    cancelled.push_back(timers.cancel(scheduled[2]));
+    assert(timers.empty() && (cancelled == std::vector<bool> { true, true, true, false, false }));
+
+    // expire() pops everything due, including timers the visitor adds.
+    std::vector<int> fired;
+    timers.schedule({ 10, 1 });  // NOLINT: arbitrary tick
+    timers.schedule({ 1000, 2 });  // NOLINT: arbitrary tick
+    auto expired = timers.expire(100, [&timers, &fired](const Timer &timer) {  // NOLINT: arbitrary tick
+        fired.push_back(timer.id);
+        if (timer.id == 1) {
+            timers.schedule({ timer.deadline + 30, 1 });  // NOLINT: period
+        }
+    });
+    assert(expired == 4 && (fired == std::vector<int> { 1, 1, 1, 1 }));
+    assert(timers.size() == 2 && timers.nextDeadline() == 130);  // NOLINT: 100 + 30
+    (void)expired;
+
+    // updatePriorities() picks up changed deadlines.
+    std::vector<std::uint64_t> deadlines { 50, 2000, 70000 };  // NOLINT: arbitrary ticks
+    TimingWheelPQ<const std::uint64_t *, TickPtrComp, TickPtrDeadline> pointers {};
+    for (auto &deadline : deadlines) {
+        pointers.push(&deadline);
+    }
+    deadlines[2] = 10;  // NOLINT: now the earliest
+    pointers.updatePriorities();
+    assert(pointers.top() == &deadlines[2]);
+
+    // Random schedules, cancels and pops, checked against a std::set.
+    std::mt19937 rng { 281 };  // NOLINT: fixed seed
+    TimingWheelPQ<Timer, TimerComp, TimerDeadline> random {};
+    std::set<Timer> live;
+    std::vector<std::pair<Timer, TimingWheelPQ<Timer, TimerComp, TimerDeadline>::Handle>> handles;
+    std::uint64_t clock = 0;
+    bool matched = true;
+    for (int id = 0; id < 20000; ++id) {  // NOLINT: arbitrary count
+        auto op = rng() % 4;
+        if (op < 2) {
+            std::uint64_t delay = rng() % (std::uint64_t { 1 } << (rng() % 34));  // NOLINT: up to 2^33 ticks
+            Timer timer { clock + delay, id };
+            handles.emplace_back(timer, random.schedule(timer));
+            live.insert(timer);
+        } else if (op == 2 && !handles.empty()) {
+            auto pick = rng() % handles.size();
+            matched &= random.cancel(handles[pick].second) == (live.erase(handles[pick].first) == 1);
+        } else if (!live.empty()) {
+            Timer top = random.top();
+            matched &= top.id == live.begin()->id;
+            clock = top.deadline;
+            live.erase(live.begin());
+            random.pop();
+        }
+        matched &= random.size() == live.size();
+    }
+    assert(matched);
+    (void)matched;
+
+    std::cout << "testTimingWheel succeeded!" << std::endl;
+}
+
+
+// Test the simulation kernel with PQ as its event queue: batches of events
+// due at the same time, in scheduling order, with payloads that are never
+// copied and are destroyed once handled.
+template <template <typename...> typename PQ>
+void testSimulation() {
+    std::cout << "Testing the simulation kernel..." << std::endl;
+
+    // Can be neither copied nor moved, and counts how many are alive.
+    struct Job {
+        int id;
+        int *live;
+        Job(int id, int &live) : id { id }, live { &live } { ++live; }
+        Job(const Job &) = delete;
+        Job &operator=(const Job &) = delete;
+        ~Job() { --*live; }
+    };
+
+    int live = 0;
+    std::vector<std::pair<SimTime, std::vector<int>>> batches;
+    {
+        Simulation<Job, PQ> sim {};
+        for (int id : { 1, 2, 3 }) {
+            sim.schedule(10, id, live);  // NOLINT: arbitrary time
+        }
+        sim.schedule(5, 4, live);    // NOLINT: arbitrary time and id
+        sim.schedule(200, 5, live);  // NOLINT: beyond the first wheel level
+        assert(live == 5 && sim.size() == 5);
+
+        auto handled = sim.run([&batches, &live](Simulation<Job, PQ> &s, const auto &batch) {
+            batches.emplace_back(batch.time(), std::vector<int> {});
+            for (const Job &job : batch) {
+                batches.back().second.push_back(job.id);
+                // Job 2 schedules a job for now and one for later.
+                if (job.id == 2) {
+                    s.schedule(s.now(), 6, live);  // NOLINT: arbitrary id
+                    s.schedule(s.now() + 1, 7, live);  // NOLINT: arbitrary id
+                }
+            }
+        }, 100);  // NOLINT: stop before job 5
+        assert(handled == 6);
+        (void)handled;
+        assert(sim.now() == 11 && sim.size() == 1 && live == 1);  // NOLINT: job 7's time
+
+        bool thrown = false;
+        try {
+            sim.schedule(1, 8, live);  // NOLINT: in the past
+        } catch (const std::invalid_argument &) {
+            thrown = true;
+        }
+        assert(thrown && live == 1);
+        (void)thrown;
+        assert(sim.run([](auto &, const auto &) {}) == 1 && sim.empty());
+
+        // Slots are reused once their jobs are handled.
+        sim.schedule(300, 9, live);  // NOLINT: arbitrary time and id
+    }
+    assert(live == 0);
+
+    const std::vector<std::pair<SimTime, std::vector<int>>> expected {
+        { 5, { 4 } }, { 10, { 1, 2, 3 } }, { 10, { 6 } }, { 11, { 7 } },  // NOLINT: as scheduled
+    };
+    assert(batches == expected);
+
+    std::cout << "testSimulation succeeded!" << std::endl;
+}
+
+
+// Test BinaryPQ::replaceTop(), including with handles and in stable mode.
+void testReplaceTop() {
+    std::cout << "Testing replaceTop()..." << std::endl;
+
+    BinaryPQ<int> pq {};
+    pq.replaceTop(5);  // NOLINT: arbitrary value; same as push() when empty
+    for (int value : { 9, 1, 7 }) {  // NOLINT: arbitrary values
+        pq.push(value);
+    }
+    pq.replaceTop(3);
+    assert(pq.size() == 4 && pq.top() == 7);
+    pq.replaceTop(8);  // NOLINT: arbitrary value
+    assert(pq.top() == 8);
+
+    // Replacing the top can bring an erased element up; it must not show.
+    BinaryPQ<int> tracked {};
+    tracked.pushHandle(10);  // NOLINT: arbitrary value
+    auto nine = tracked.pushHandle(9);  // NOLINT: arbitrary value
+    tracked.pushHandle(2);
+    tracked.erase(nine);
+    tracked.replaceTop(1);
+    assert(tracked.size() == 2 && tracked.top() == 2);
+
+    // In stable mode the replacement counts as the newest element.
+    BinaryPQ<Event, EventComp> stable {};
+    stable.setStable(true);
+    stable.push({ 1, 0 });
+    stable.push({ 1, 1 });
+    stable.replaceTop({ 1, 2 });
+    std::vector<Event> popped;
+    while (!stable.empty()) {
+        popped.push_back(stable.top());
+        stable.pop();
+    }
+    assert(popped.size() == 2 && popped[0].id == 1 && popped[1].id == 2);
+
+    std::cout << "testReplaceTop succeeded!" << std::endl;
+}
+
+
+// Test merging sorted runs, with both strategies, against a stable sort.
+void testMerge() {
+    std::cout << "Testing k-way merge..." << std::endl;
+
+    // Runs of Events sorted by key, with ties across runs and empty runs.
+    std::vector<std::vector<Event>> runs(7);  // NOLINT: arbitrary count
+    int id = 0;
+    for (std::size_t run = 0; run < runs.size(); ++run) {
+        for (std::size_t i = 0; i < run * 3 % 7; ++i) {  // NOLINT: lengths 0-6
+            runs[run].push_back({ static_cast<int>((run + i * 5) % 11), 0 });  // NOLINT: scrambled keys
+        }
+        std::sort(runs[run].begin(), runs[run].end(), EventComp {});
+        for (auto &event : runs[run]) {
+            event.id = id++;
+        }
+    }
+    std::vector<Event> expected;
+    std::vector<MergeRun<std::vector<Event>::const_iterator>> ranges;
+    for (const auto &run : runs) {
+        expected.insert(expected.end(), run.begin(), run.end());
+        ranges.emplace_back(run.cbegin(), run.cend());
+    }
+    std::stable_sort(expected.begin(), expected.end(), EventComp {});
+
+    for (auto strategy : { MergeStrategy::Heap, MergeStrategy::LoserTree }) {
+        std::vector<Event> merged;
+        kWayMerge(ranges, std::back_inserter(merged), EventComp {}, strategy);
+        assert(merged.size() == expected.size());
+        for (std::size_t i = 0; i < merged.size(); ++i) {
+            assert(merged[i].id == expected[i].id);
+        }
+
+        // No runs, and a single run, reverse sorted.
+        std::vector<int> out;
+        kWayMerge(std::vector<MergeRun<const int *>> {}, std::back_inserter(out), std::less<int> {}, strategy);
+        const std::vector<int> single { 9, 4, 4, 1 };
+        kWayMerge(std::vector<MergeRun<std::vector<int>::const_iterator>> { { single.cbegin(), single.cend() } },
+                  std::back_inserter(out), std::greater<int> {}, strategy);
+        assert(out == single);
+    }
+
+    // The merges can also be consumed as streams.
+    LoserTreeMerge<std::vector<Event>::const_iterator, EventComp> stream { ranges };
+    std::size_t streamed = 0;
+    while (!stream.empty()) {
+        assert(stream.top().id == expected[streamed].id);
+        stream.pop();
+        ++streamed;
+    }
+    assert(streamed == expected.size());
+
+    std::cout << "testMerge succeeded!" << std::endl;
+}
+
+
+// Test pq_sort() against std::sort, serially and split over threads.
+void testPQSort() {
+    std::cout << "Testing pq_sort()..." << std::endl;
+
+    ParallelOptions threads;
+    threads.threads = 4;  // NOLINT: more threads than this machine may have
+    threads.min_size = 2;
+
+    std::mt19937 rng { 281 };  // NOLINT: fixed seed
+    for (std::size_t n : { 0, 1, 2, 3, 5, 100, 1000 }) {  // NOLINT: sizes around the thread count
+        std::vector<int> values(n);
+        for (auto &value : values) {
+            value = static_cast<int>(rng() % 50);  // NOLINT: plenty of duplicates
+        }
+        std::vector<int> expected { values };
+        std::sort(expected.begin(), expected.end());
+
+        for (auto options : { ParallelOptions {}, threads }) {
+            std::vector<int> sorted { values };
+            pq_sort(sorted.begin(), sorted.end(), std::less<int> {}, options);
+            assert(sorted == expected);
+        }
+        std::vector<int> descending { values };
+        pq_sort(descending.begin(), descending.end(), std::greater<int> {}, threads);
+        assert(std::equal(descending.begin(), descending.end(), expected.rbegin()));
+    }
+
+    // Elements that are expensive to copy are moved, and every one survives.
+    std::vector<std::string> words;
+    for (int i = 0; i < 500; ++i) {  // NOLINT: arbitrary count
+        words.push_back(std::string(40, 'a') + std::to_string(rng() % 200));  // NOLINT: long strings
+    }
+    std::vector<std::string> expected { words };
+    std::sort(expected.begin(), expected.end());
+    pq_sort(words.begin(), words.end(), std::less<std::string> {}, threads);
+    assert(words == expected);
+
+    // All equal elements put every one of them in the same slice.
+    std::vector<int> same(100, 7);  // NOLINT: arbitrary values
+    pq_sort(same.begin(), same.end(), std::less<int> {}, threads);
+    assert(same == std::vector<int>(100, 7));  // NOLINT: arbitrary values
+
+    // The defaults, on a plain array.
+    int array[] = { 3, 1, 2 };
+    pq_sort(std::begin(array), std::end(array));
+    assert(array[0] == 1 && array[1] == 2 && array[2] == 3);
+
+    std::cout << "testPQSort succeeded!" << std::endl;
+}
+
+
 // Run all tests for a particular PQ type.
 template <template <typename...> typename PQ>
 void testPriorityQueue() {
     testPrimitiveOperations<PQ>();
     testHiddenData<PQ>();
     testUpdatePriorities<PQ>();
+    testSnapshot<PQ>();
+    testStats<PQ>();
+    testTraced<PQ>();
+}
+
+// UnorderedPQ takes an allocator, like the other array-based PQs.
+template <>
+void testPriorityQueue<UnorderedPQ>() {
+    testPrimitiveOperations<UnorderedPQ>();
+    testHiddenData<UnorderedPQ>();
+    testUpdatePriorities<UnorderedPQ>();
+    testSnapshot<UnorderedPQ>();
+    testStats<UnorderedPQ>();
+    testTraced<UnorderedPQ>();
+    testByKey<UnorderedPQ>();
+    testAllocator<UnorderedPQ>();
 }
 
 // PairingPQ has some extra behavior we need to test in updateElement.
@@ -221,16 +1864,142 @@ void testPriorityQueue<PairingPQ>() {
     testPrimitiveOperations<PairingPQ>();
     testHiddenData<PairingPQ>();
     testUpdatePriorities<PairingPQ>();
+    testSnapshot<PairingPQ>();
+    testStats<PairingPQ>();
+    testTraced<PairingPQ>();
+    testStable<PairingPQ>();
     testPairing();
+    testShortestPaths<PairingPQ>();
+    testSimulation<PairingPQ>();
+}
+
+// The array heaps support lazy erasure through handles.
+template <>
+void testPriorityQueue<BinaryPQ>() {
+    testPrimitiveOperations<BinaryPQ>();
+    testHiddenData<BinaryPQ>();
+    testUpdatePriorities<BinaryPQ>();
+    testSnapshot<BinaryPQ>();
+    testStats<BinaryPQ>();
+    testTraced<BinaryPQ>();
+    testStable<BinaryPQ>();
+    testByKey<BinaryPQ>();
+    testParallel<BinaryPQ>();
+    testTombstones<BinaryPQ>();
+    testReplaceTop();
+    testMerge();
+    testPQSort();
+    testSimulation<BinaryPQ>();
+    testAllocator<BinaryPQ>();
+    testHugePages();
+    testMappedBinary();
+    testSharedBinary();
+#if __cplusplus >= 202002L
+    testAsync();
+#endif
+}
+
+template <>
+void testPriorityQueue<UnorderedFastPQ>() {
+    testPrimitiveOperations<UnorderedFastPQ>();
+    testHiddenData<UnorderedFastPQ>();
+    testUpdatePriorities<UnorderedFastPQ>();
+    testSnapshot<UnorderedFastPQ>();
+    testStats<UnorderedFastPQ>();
+    testTraced<UnorderedFastPQ>();
+    testByKey<UnorderedFastPQ>();
+    testTombstones<UnorderedFastPQ>();
+    testAllocator<UnorderedFastPQ>();
+}
+
+// ExternalPQ is tested with a tiny memory budget as well.
+template <>
+void testPriorityQueue<ExternalPQ>() {
+    testPrimitiveOperations<ExternalPQ>();
+    testHiddenData<ExternalPQ>();
+    testUpdatePriorities<ExternalPQ>();
+    testTraced<ExternalPQ>();
+    testExternal();
+}
+
+template <>
+void testPriorityQueue<PersistentPQ>() {
+    testPrimitiveOperations<PersistentPQ>();
+    testHiddenData<PersistentPQ>();
+    testUpdatePriorities<PersistentPQ>();
+    testSnapshot<PersistentPQ>();
+    testStats<PersistentPQ>();
+    testTraced<PersistentPQ>();
+    testPersistent();
+}
+
+// BatchPQ shards across threads like the parallel rebuilds.
+template <>
+void testPriorityQueue<BatchPQ>() {
+    testPrimitiveOperations<BatchPQ>();
+    testHiddenData<BatchPQ>();
+    testUpdatePriorities<BatchPQ>();
+    testSnapshot<BatchPQ>();
+    testStats<BatchPQ>();
+    testTraced<BatchPQ>();
+    testParallel<BatchPQ>();
+    testBatch();
+}
+
+// HollowPQ shares PairingPQ's handle interface.
+template <>
+void testPriorityQueue<HollowPQ>() {
+    testPrimitiveOperations<HollowPQ>();
+    testHiddenData<HollowPQ>();
+    testUpdatePriorities<HollowPQ>();
+    testSnapshot<HollowPQ>();
+    testStats<HollowPQ>();
+    testTraced<HollowPQ>();
+    testHollow();
+    testShortestPaths<HollowPQ>();
+}
+
+// SmallPQ is tested through TinyPQ, and at its default size.
+template <>
+void testPriorityQueue<TinyPQ>() {
+    testPrimitiveOperations<TinyPQ>();
+    testHiddenData<TinyPQ>();
+    testUpdatePriorities<TinyPQ>();
+    testSnapshot<TinyPQ>();
+    testStats<TinyPQ>();
+    testTraced<TinyPQ>();
+    testSmall();
+}
+
+// SortedPQ exposes its sorted order through iterators and range queries.
+template <>
+void testPriorityQueue<SortedPQ>() {
+    testPrimitiveOperations<SortedPQ>();
+    testHiddenData<SortedPQ>();
+    testUpdatePriorities<SortedPQ>();
+    testSnapshot<SortedPQ>();
+    testStats<SortedPQ>();
+    testTraced<SortedPQ>();
+    testStable<SortedPQ>();
+    testParallel<SortedPQ>();
+    testAllocator<SortedPQ>();
+    testSorted();
 }
 
 
 int main() {
     const std::vector<PQType> types {
         PQType::Unordered,
+        PQType::UnorderedFast,
         PQType::Sorted,
         PQType::Binary,
         PQType::Pairing,
+        PQType::External,
+        PQType::Hollow,
+        PQType::Small,
+        PQType::TimingWheel,
+        PQType::Persistent,
+        PQType::Batch,
     };
 
     std::cout << "PQ tester" << std::endl << std::endl;
@@ -252,6 +2021,37 @@ int main() {
     case PQType::Unordered:
         testPriorityQueue<UnorderedPQ>();
         break;
+    case PQType::UnorderedFast:
+        testPriorityQueue<UnorderedFastPQ>();
+        break;
+    case PQType::Sorted:
+        testPriorityQueue<SortedPQ>();
+        break;
+    case PQType::Binary:
+        testPriorityQueue<BinaryPQ>();
+        break;
+    case PQType::Pairing:
+        testPriorityQueue<PairingPQ>();
+        break;
+    case PQType::External:
+        testPriorityQueue<ExternalPQ>();
+        break;
+    case PQType::Hollow:
+        testPriorityQueue<HollowPQ>();
+        break;
+    case PQType::Small:
+        testPriorityQueue<TinyPQ>();
+        break;
+    case PQType::TimingWheel:
+        testTimingWheel();
+        testSimulation<CalendarQueue>();
+        break;
+    case PQType::Persistent:
+        testPriorityQueue<PersistentPQ>();
+        break;
+    case PQType::Batch:
+        testPriorityQueue<BatchPQ>();
+        break;
     default:
         std::cout << "Unrecognized PQ type " << pqType << " in main.\n"
                   << "You must add tests for all PQ types." << std::endl;